@@ -24,9 +24,13 @@ public:
   caption() const override
   { return QStringLiteral("Addition"); }
 
+  static QString
+  Name()
+  { return QStringLiteral("Addition"); }
+
   QString
   name() const override
-  { return QStringLiteral("Addition"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
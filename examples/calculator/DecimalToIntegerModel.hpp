@@ -37,9 +37,13 @@ public:
   captionVisible() const override
   { return false; }
 
+  static QString
+  Name()
+  { return QStringLiteral("DecimalToInteger"); }
+
   QString
   name() const override
-  { return QStringLiteral("DecimalToInteger"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
@@ -49,9 +49,13 @@ public:
     return QString();
   }
 
+  static QString
+  Name()
+  { return QStringLiteral("Division"); }
+
   QString
   name() const override
-  { return QStringLiteral("Division"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
@@ -63,9 +63,13 @@ public:
     return QString();
   }
 
+  static QString
+  Name()
+  { return QStringLiteral("Modulo"); }
+
   QString
   name() const override
-  { return QStringLiteral("Modulo"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
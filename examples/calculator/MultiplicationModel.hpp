@@ -24,9 +24,13 @@ public:
   caption() const override
   { return QStringLiteral("Multiplication"); }
 
+  static QString
+  Name()
+  { return QStringLiteral("Multiplication"); }
+
   QString
   name() const override
-  { return QStringLiteral("Multiplication"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
@@ -36,9 +36,13 @@ public:
   captionVisible() const override
   { return false; }
 
+  static QString
+  Name()
+  { return QStringLiteral("Result"); }
+
   QString
   name() const override
-  { return QStringLiteral("Result"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
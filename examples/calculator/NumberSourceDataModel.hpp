@@ -39,9 +39,13 @@ public:
   captionVisible() const override
   { return false; }
 
+  static QString
+  Name()
+  { return QStringLiteral("NumberSource"); }
+
   QString
   name() const override
-  { return QStringLiteral("NumberSource"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
@@ -50,9 +50,13 @@ public:
     return QString();
   }
 
+  static QString
+  Name()
+  { return QStringLiteral("Subtraction"); }
+
   QString
   name() const override
-  { return QStringLiteral("Subtraction"); }
+  { return Name(); }
 
   std::unique_ptr<NodeDataModel>
   clone() const override
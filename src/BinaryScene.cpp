@@ -0,0 +1,616 @@
+#include "BinaryScene.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include <QtCore/QtEndian>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+
+namespace QtNodes {
+
+namespace
+{
+
+std::uint32_t const NoString = std::numeric_limits<std::uint32_t>::max();
+
+template<typename T>
+void
+appendInteger(QByteArray& out, T value)
+{
+  char bytes[sizeof(T)];
+  qToLittleEndian(value, reinterpret_cast<uchar*>(bytes));
+  out.append(bytes, sizeof(T));
+}
+
+void
+appendDouble(QByteArray& out, double value)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendInteger<quint64>(out, bits);
+}
+
+void
+appendVarint(QByteArray& out, std::uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    out.append(char((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.append(char(value));
+}
+
+void
+appendUuid(QByteArray& out, QUuid const& id)
+{
+  out.append(id.toRfc4122());
+}
+
+void
+appendLengthPrefixed(QByteArray& out, QByteArray const& bytes)
+{
+  appendVarint(out, bytes.size());
+  out.append(bytes);
+}
+
+/// Bounds checked sequential reads, `ok` turns false on the first overrun
+class Cursor
+{
+public:
+
+  Cursor(char const* data, std::size_t size, std::size_t position)
+    : _data(data)
+    , _size(size)
+    , _position(position)
+    , _ok(position <= size)
+  {}
+
+  bool
+  ok() const { return _ok; }
+
+  std::size_t
+  position() const { return _position; }
+
+  template<typename T>
+  T
+  integer()
+  {
+    if (!take(sizeof(T)))
+      return T();
+
+    return qFromLittleEndian<T>(reinterpret_cast<uchar const*>(_data + _position - sizeof(T)));
+  }
+
+  double
+  real()
+  {
+    std::uint64_t bits = integer<quint64>();
+
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::uint64_t
+  varint()
+  {
+    std::uint64_t value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      if (!take(1))
+        return 0;
+
+      auto const byte = static_cast<unsigned char>(_data[_position - 1]);
+
+      value |= std::uint64_t(byte & 0x7f) << shift;
+
+      if (!(byte & 0x80))
+        return value;
+    }
+
+    _ok = false;
+    return 0;
+  }
+
+  QUuid
+  uuid()
+  {
+    if (!take(16))
+      return QUuid();
+
+    return QUuid::fromRfc4122(QByteArray::fromRawData(_data + _position - 16, 16));
+  }
+
+  /// Pointer to the next `size` bytes, nullptr if there are not enough
+  char const*
+  bytes(std::size_t size)
+  {
+    if (!take(size))
+      return nullptr;
+
+    return _data + _position - size;
+  }
+
+private:
+
+  bool
+  take(std::size_t size)
+  {
+    if (!_ok || _size - _position < size)
+    {
+      _ok = false;
+      return false;
+    }
+
+    _position += size;
+    return true;
+  }
+
+private:
+
+  char const* _data;
+  std::size_t _size;
+  std::size_t _position;
+  bool        _ok;
+};
+
+}
+
+// BinaryScene --------------------------------------------------------------
+
+bool
+BinaryScene::
+isBinary(QByteArray const& data)
+{
+  return data.size() >= int(HeaderSize) &&
+         std::memcmp(data.constData(), Magic, sizeof(Magic)) == 0;
+}
+
+
+QByteArray
+BinaryScene::
+fromJson(QJsonObject const& scene)
+{
+  QJsonArray const nodes       = scene["nodes"].toArray();
+  QJsonArray const connections = scene["connections"].toArray();
+
+  BinarySceneWriter writer(nodes.size(), connections.size());
+
+  for (QJsonValue const& value : nodes)
+  {
+    QJsonObject const node     = value.toObject();
+    QJsonObject const position = node["position"].toObject();
+
+    writer.addNode(QUuid(node["id"].toString()),
+                   QPointF(position["x"].toDouble(), position["y"].toDouble()),
+                   node["model"].toObject());
+  }
+
+  for (QJsonValue const& value : connections)
+  {
+    QJsonObject const connection = value.toObject();
+
+    writer.addConnection(QUuid(connection["out_id"].toString()),
+                         connection["out_index"].toInt(),
+                         QUuid(connection["in_id"].toString()),
+                         connection["in_index"].toInt());
+  }
+
+  QJsonObject extra = scene;
+  extra.remove("nodes");
+  extra.remove("connections");
+  writer.setExtra(extra);
+
+  return writer.finish();
+}
+
+
+QJsonObject
+BinaryScene::
+toJson(QByteArray const& data)
+{
+  BinarySceneReader reader(data);
+
+  std::vector<BinarySceneReader::ConnectionEntry> connections;
+
+  if (!reader.isValid() || !reader.connections(connections))
+    return QJsonObject();
+
+  QJsonObject scene = reader.extra();
+
+  QJsonArray nodesJson;
+  for (std::size_t i = 0; i < reader.nodeCount(); ++i)
+  {
+    auto const node = reader.node(i);
+
+    QJsonObject position;
+    position["x"] = node.position.x();
+    position["y"] = node.position.y();
+
+    QJsonObject nodeJson;
+    nodeJson["id"]       = node.id.toString();
+    nodeJson["model"]    = reader.modelState(node);
+    nodeJson["position"] = position;
+
+    nodesJson.append(nodeJson);
+  }
+  scene["nodes"] = nodesJson;
+
+  QJsonArray connectionsJson;
+  for (auto const& connection : connections)
+  {
+    QJsonObject connectionJson;
+    connectionJson["in_id"]     = connection.inNode.toString();
+    connectionJson["in_index"]  = connection.inPort;
+    connectionJson["out_id"]    = connection.outNode.toString();
+    connectionJson["out_index"] = connection.outPort;
+
+    connectionsJson.append(connectionJson);
+  }
+  scene["connections"] = connectionsJson;
+
+  return scene;
+}
+
+// BinarySceneWriter --------------------------------------------------------
+
+BinarySceneWriter::
+BinarySceneWriter(std::size_t nodeCountHint, std::size_t connectionCountHint)
+{
+  _nodeIndices.reserve(nodeCountHint);
+  _connections.reserve(connectionCountHint);
+  _nodeTable.reserve(int(nodeCountHint * BinaryScene::NodeRecordSize));
+}
+
+
+void
+BinarySceneWriter::
+addNode(QUuid const& id, QPointF const& position, QJsonObject modelState)
+{
+  QString modelName;
+  QByteArray const blob = encodeState(std::move(modelState), modelName);
+
+  addNode(id, position, modelName, blob);
+}
+
+
+void
+BinarySceneWriter::
+addNode(QUuid const& id, QPointF const& position,
+        QString const& modelName, QByteArray const& blob)
+{
+  std::uint32_t const nameIndex = modelName.isNull() ? NoString : internString(modelName);
+
+  _nodeIndices.emplace(id, _nodeTable.size() / BinaryScene::NodeRecordSize);
+
+  appendUuid(_nodeTable, id);
+  appendInteger<quint32>(_nodeTable, nameIndex);
+  appendDouble(_nodeTable, position.x());
+  appendDouble(_nodeTable, position.y());
+  appendInteger<quint64>(_nodeTable, _blobs.size());
+  appendInteger<quint32>(_nodeTable, blob.size());
+
+  _blobs.append(blob);
+}
+
+
+QByteArray
+BinarySceneWriter::
+encodeState(QJsonObject modelState, QString& modelName)
+{
+  modelName = QString();
+
+  auto name = modelState.find("name");
+  if (name != modelState.end() && name.value().isString())
+  {
+    modelName = name.value().toString();
+    modelState.erase(name);
+  }
+
+  return QJsonDocument(modelState).toJson(QJsonDocument::Compact);
+}
+
+
+void
+BinarySceneWriter::
+addConnection(QUuid const& outNode, PortIndex outPort,
+              QUuid const& inNode, PortIndex inPort)
+{
+  _connections.push_back(PendingConnection{outNode, outPort, inNode, inPort});
+}
+
+
+void
+BinarySceneWriter::
+setExtra(QJsonObject const& extra)
+{
+  _extra = extra.isEmpty() ? QByteArray() : QJsonDocument(extra).toJson(QJsonDocument::Compact);
+}
+
+
+QByteArray
+BinarySceneWriter::
+finish()
+{
+  QByteArray strings;
+  for (QString const& string : _strings)
+  {
+    appendLengthPrefixed(strings, string.toUtf8());
+  }
+
+  QByteArray connections;
+  connections.reserve(int(_connections.size() * 4));
+
+  auto appendNode = [&](QUuid const& id) {
+    auto iter = _nodeIndices.find(id);
+
+    if (iter != _nodeIndices.end())
+    {
+      appendVarint(connections, iter->second + 1);
+    }
+    else
+    {
+      appendVarint(connections, 0);
+      appendUuid(connections, id);
+    }
+  };
+
+  for (auto const& connection : _connections)
+  {
+    appendNode(connection.outNode);
+    appendVarint(connections, std::uint64_t(connection.outPort));
+    appendNode(connection.inNode);
+    appendVarint(connections, std::uint64_t(connection.inPort));
+  }
+
+  QByteArray extra;
+  appendLengthPrefixed(extra, _extra);
+
+  quint64 const stringOffset     = BinaryScene::HeaderSize;
+  quint64 const nodeOffset       = stringOffset + strings.size();
+  quint64 const connectionOffset = nodeOffset + _nodeTable.size();
+  quint64 const extraOffset      = connectionOffset + connections.size();
+  quint64 const blobOffset       = extraOffset + extra.size();
+
+  QByteArray out;
+  out.reserve(int(blobOffset + _blobs.size()));
+
+  out.append(BinaryScene::Magic, sizeof(BinaryScene::Magic));
+  appendInteger<quint16>(out, BinaryScene::Version);
+  appendInteger<quint16>(out, 0);
+
+  appendInteger<quint64>(out, stringOffset);
+  appendInteger<quint64>(out, nodeOffset);
+  appendInteger<quint64>(out, connectionOffset);
+  appendInteger<quint64>(out, extraOffset);
+  appendInteger<quint64>(out, blobOffset);
+
+  appendInteger<quint64>(out, _strings.size());
+  appendInteger<quint64>(out, _nodeTable.size() / BinaryScene::NodeRecordSize);
+  appendInteger<quint64>(out, _connections.size());
+
+  Q_ASSERT(out.size() == int(BinaryScene::HeaderSize));
+
+  out.append(strings);
+  out.append(_nodeTable);
+  out.append(connections);
+  out.append(extra);
+  out.append(_blobs);
+
+  return out;
+}
+
+
+std::uint32_t
+BinarySceneWriter::
+internString(QString const& string)
+{
+  auto iter = _stringIndices.find(string);
+
+  if (iter != _stringIndices.end())
+    return iter->second;
+
+  std::uint32_t const index = std::uint32_t(_strings.size());
+
+  _strings.push_back(string);
+  _stringIndices.emplace(string, index);
+
+  return index;
+}
+
+// BinarySceneReader --------------------------------------------------------
+
+BinarySceneReader::
+BinarySceneReader(char const* data, std::size_t size)
+  : _data(data)
+  , _size(size)
+{
+  open();
+}
+
+
+BinarySceneReader::
+BinarySceneReader(QByteArray const& data)
+  : BinarySceneReader(data.constData(), std::size_t(data.size()))
+{}
+
+
+void
+BinarySceneReader::
+open()
+{
+  Cursor header(_data, _size, 0);
+
+  char const* magic = header.bytes(sizeof(BinaryScene::Magic));
+
+  if (!magic || std::memcmp(magic, BinaryScene::Magic, sizeof(BinaryScene::Magic)) != 0)
+    return;
+
+  if (header.integer<quint16>() != BinaryScene::Version)
+    return;
+
+  header.integer<quint16>(); // flags
+
+  quint64 const stringOffset = header.integer<quint64>();
+  _nodeTableOffset           = header.integer<quint64>();
+  _connectionTableOffset     = header.integer<quint64>();
+  _extraOffset               = header.integer<quint64>();
+  _blobOffset                = header.integer<quint64>();
+
+  quint64 const stringCount = header.integer<quint64>();
+  _nodeCount                = header.integer<quint64>();
+  _connectionCount          = header.integer<quint64>();
+
+  if (!header.ok())
+    return;
+
+  // sections in order and inside the data
+  if (stringOffset < BinaryScene::HeaderSize ||
+      _nodeTableOffset < stringOffset ||
+      _connectionTableOffset < _nodeTableOffset ||
+      _extraOffset < _connectionTableOffset ||
+      _blobOffset < _extraOffset ||
+      _blobOffset > _size ||
+      (_connectionTableOffset - _nodeTableOffset) / BinaryScene::NodeRecordSize != _nodeCount ||
+      (_connectionTableOffset - _nodeTableOffset) % BinaryScene::NodeRecordSize != 0)
+    return;
+
+  Cursor strings(_data, _nodeTableOffset, stringOffset);
+
+  _strings.reserve(std::size_t(std::min<quint64>(stringCount, _size)));
+
+  for (quint64 i = 0; i < stringCount; ++i)
+  {
+    std::size_t const length = std::size_t(strings.varint());
+    char const* bytes = strings.bytes(length);
+
+    if (!bytes)
+      return;
+
+    _strings.push_back(QString::fromUtf8(bytes, int(length)));
+  }
+
+  _valid = true;
+}
+
+
+BinarySceneReader::NodeEntry
+BinarySceneReader::
+node(std::size_t index) const
+{
+  Q_ASSERT(_valid && index < _nodeCount);
+
+  Cursor record(_data, _size, _nodeTableOffset + index * BinaryScene::NodeRecordSize);
+
+  NodeEntry entry;
+
+  entry.id = record.uuid();
+
+  std::uint32_t const nameIndex = record.integer<quint32>();
+  if (nameIndex < _strings.size())
+    entry.modelName = _strings[nameIndex];
+
+  double const x = record.real();
+  double const y = record.real();
+  entry.position = QPointF(x, y);
+
+  entry.blobOffset = record.integer<quint64>();
+  entry.blobLength = record.integer<quint32>();
+
+  return entry;
+}
+
+
+QJsonObject
+BinarySceneReader::
+modelState(NodeEntry const& node) const
+{
+  QJsonObject state;
+
+  if (node.blobOffset <= _size - _blobOffset &&
+      node.blobLength <= _size - _blobOffset - node.blobOffset)
+  {
+    state = QJsonDocument::fromJson(QByteArray::fromRawData(_data + _blobOffset + node.blobOffset,
+                                                            int(node.blobLength))).object();
+  }
+
+  if (!node.modelName.isNull())
+    state["name"] = node.modelName;
+
+  return state;
+}
+
+
+bool
+BinarySceneReader::
+connections(std::vector<ConnectionEntry>& result) const
+{
+  result.clear();
+
+  if (!_valid)
+    return false;
+
+  result.reserve(std::size_t(std::min<std::uint64_t>(_connectionCount, _extraOffset - _connectionTableOffset)));
+
+  Cursor cursor(_data, _extraOffset, _connectionTableOffset);
+
+  auto readNode = [&]() {
+    std::uint64_t const reference = cursor.varint();
+
+    if (reference == 0)
+      return cursor.uuid();
+
+    if (reference > _nodeCount)
+    {
+      // make the cursor fail
+      cursor.bytes(_size);
+      return QUuid();
+    }
+
+    Cursor record(_data, _size, _nodeTableOffset + (reference - 1) * BinaryScene::NodeRecordSize);
+    return record.uuid();
+  };
+
+  for (std::size_t i = 0; i < _connectionCount; ++i)
+  {
+    ConnectionEntry entry;
+
+    entry.outNode = readNode();
+    entry.outPort = PortIndex(cursor.varint());
+    entry.inNode  = readNode();
+    entry.inPort  = PortIndex(cursor.varint());
+
+    if (!cursor.ok())
+    {
+      result.clear();
+      return false;
+    }
+
+    result.push_back(entry);
+  }
+
+  return true;
+}
+
+
+QJsonObject
+BinarySceneReader::
+extra() const
+{
+  if (!_valid)
+    return QJsonObject();
+
+  Cursor cursor(_data, _blobOffset, _extraOffset);
+
+  std::size_t const length = std::size_t(cursor.varint());
+  char const* bytes = cursor.bytes(length);
+
+  if (!bytes || length == 0)
+    return QJsonObject();
+
+  return QJsonDocument::fromJson(QByteArray::fromRawData(bytes, int(length))).object();
+}
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include <QtCore/QUuid>
+#include <QtCore/QString>
+#include <QtCore/QPointF>
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+
+#include "Export.hpp"
+#include "PortType.hpp"
+#include "QUuidStdHash.hpp"
+#include "QStringStdHash.hpp"
+
+namespace QtNodes
+{
+
+/// Binary scene format, an alternative to the JSON of
+/// `DataFlowScene::saveToMemory` carrying the same information.
+///
+/// All integers are little endian.
+///
+///     header       magic "QNSB", u16 version, u16 flags,
+///                  u64 offsets of the string table, node table,
+///                  connection table, extra section and blob section,
+///                  u64 string, node and connection counts
+///     strings      varint length + UTF-8, model names
+///     nodes        fixed size records: 16 byte RFC 4122 uuid,
+///                  u32 model name string (or ~0 for none),
+///                  f64 x, f64 y, u64 blob offset, u32 blob length
+///     connections  varint out node, varint out port,
+///                  varint in node, varint in port
+///     extra        varint length + compact JSON of any other top level
+///                  keys of the scene
+///     blobs        compact JSON of each node's model state, without the
+///                  "name" key which lives in the string table
+///
+/// A node reference is the index in the node table plus one, or 0 followed
+/// by a 16 byte uuid for connections to nodes not in the scene. The node
+/// table has fixed size records so that a node can be looked up without
+/// decoding the others.
+namespace BinaryScene
+{
+
+constexpr char          Magic[4] = {'Q', 'N', 'S', 'B'};
+constexpr std::uint16_t Version  = 1;
+
+/// Size of the fixed header and of one node record, in bytes
+constexpr std::size_t HeaderSize     = 72;
+constexpr std::size_t NodeRecordSize = 48;
+
+/// Whether `data` starts like a binary scene
+NODE_EDITOR_PUBLIC bool
+isBinary(QByteArray const& data);
+
+/// Converts a scene in the JSON layout to the binary format
+NODE_EDITOR_PUBLIC QByteArray
+fromJson(QJsonObject const& scene);
+
+/// Converts a binary scene back to the JSON layout, or returns an empty
+/// object if `data` is not a valid binary scene
+NODE_EDITOR_PUBLIC QJsonObject
+toJson(QByteArray const& data);
+
+}
+
+/// Builds a binary scene, nodes and connections may be added in any order
+class NODE_EDITOR_PUBLIC BinarySceneWriter
+{
+public:
+
+  BinarySceneWriter(std::size_t nodeCountHint = 0,
+                    std::size_t connectionCountHint = 0);
+
+  /// `modelState` is the result of `NodeDataModel::save()`
+  void
+  addNode(QUuid const& id, QPointF const& position, QJsonObject modelState);
+
+  /// Adds a node whose model state is already encoded: `blob` is the
+  /// compact JSON of the state without its "name" key, see `encodeState`
+  void
+  addNode(QUuid const& id, QPointF const& position,
+          QString const& modelName, QByteArray const& blob);
+
+  /// Splits a model state into its name and blob. Does not touch the
+  /// writer, so states can be encoded on other threads.
+  static QByteArray
+  encodeState(QJsonObject modelState, QString& modelName);
+
+  void
+  addConnection(QUuid const& outNode, PortIndex outPort,
+                QUuid const& inNode, PortIndex inPort);
+
+  /// Other top level keys to keep along with the scene
+  void
+  setExtra(QJsonObject const& extra);
+
+  QByteArray
+  finish();
+
+private:
+
+  std::uint32_t
+  internString(QString const& string);
+
+private:
+
+  std::vector<QString>                       _strings;
+  std::unordered_map<QString, std::uint32_t> _stringIndices;
+
+  std::unordered_map<QUuid, std::uint64_t> _nodeIndices;
+
+  struct PendingConnection
+  {
+    QUuid     outNode;
+    PortIndex outPort;
+    QUuid     inNode;
+    PortIndex inPort;
+  };
+
+  std::vector<PendingConnection> _connections;
+
+  QByteArray _nodeTable;
+  QByteArray _blobs;
+  QByteArray _extra;
+};
+
+
+/// Reads a binary scene in place. Opening checks the header and decodes the
+/// string table only; nodes are decoded on request and connections by
+/// `connections()`. The data must outlive the reader.
+class NODE_EDITOR_PUBLIC BinarySceneReader
+{
+public:
+
+  struct NodeEntry
+  {
+    QUuid   id;
+    QString modelName;
+    QPointF position;
+
+    std::uint64_t blobOffset;
+    std::uint32_t blobLength;
+  };
+
+  struct ConnectionEntry
+  {
+    QUuid     outNode;
+    PortIndex outPort;
+    QUuid     inNode;
+    PortIndex inPort;
+  };
+
+public:
+
+  BinarySceneReader(char const* data, std::size_t size);
+
+  explicit
+  BinarySceneReader(QByteArray const& data);
+
+  bool
+  isValid() const { return _valid; }
+
+  std::size_t
+  nodeCount() const { return _nodeCount; }
+
+  NodeEntry
+  node(std::size_t index) const;
+
+  /// Model state of a node as saved, "name" included
+  QJsonObject
+  modelState(NodeEntry const& node) const;
+
+  /// Decodes the connection table, false if it is malformed
+  bool
+  connections(std::vector<ConnectionEntry>& result) const;
+
+  QJsonObject
+  extra() const;
+
+private:
+
+  void
+  open();
+
+private:
+
+  char const* _data;
+  std::size_t _size;
+
+  bool _valid = false;
+
+  std::uint64_t _nodeTableOffset       = 0;
+  std::uint64_t _connectionTableOffset = 0;
+  std::uint64_t _extraOffset           = 0;
+  std::uint64_t _blobOffset            = 0;
+
+  std::size_t _nodeCount       = 0;
+  std::size_t _connectionCount = 0;
+
+  std::vector<QString> _strings;
+};
+}
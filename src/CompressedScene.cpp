@@ -0,0 +1,540 @@
+#include "CompressedScene.hpp"
+
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace QtNodes {
+
+namespace
+{
+
+constexpr std::size_t HeaderSize     = 36;
+constexpr std::size_t IndexEntrySize = 48;
+
+// positions are grouped by cells of this size before ordering
+constexpr double CellSize = 256.0;
+
+QDataStream&
+setUp(QDataStream& stream)
+{
+  stream.setByteOrder(QDataStream::LittleEndian);
+  stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+  return stream;
+}
+
+
+QPointF
+nodePosition(QJsonObject const& node)
+{
+  QJsonObject const position = node["position"].toObject();
+
+  return QPointF(position["x"].toDouble(), position["y"].toDouble());
+}
+
+
+/// Interleaves the bits of the cell coordinates so that nearby cells get
+/// nearby keys
+std::uint64_t
+zOrder(QPointF const& position)
+{
+  auto cell = [](double coordinate) {
+    double const c = std::floor(coordinate / CellSize) + 2147483648.0;
+    return std::uint32_t(std::min(std::max(c, 0.0), 4294967295.0));
+  };
+
+  std::uint32_t const x = cell(position.x());
+  std::uint32_t const y = cell(position.y());
+
+  std::uint64_t key = 0;
+  for (unsigned bit = 0; bit < 32; ++bit)
+  {
+    key |= std::uint64_t((x >> bit) & 1u) << (2 * bit);
+    key |= std::uint64_t((y >> bit) & 1u) << (2 * bit + 1);
+  }
+
+  return key;
+}
+
+
+QByteArray
+compress(QJsonValue const& value, int level)
+{
+  QByteArray const json = value.isArray()
+                          ? QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact)
+                          : QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact);
+
+  return qCompress(json, level);
+}
+
+
+/// Identifies a connection stored in two chunks
+QString
+connectionKey(QJsonObject const& connection)
+{
+  return connection["out_id"].toString() + QLatin1Char(':') +
+         QString::number(connection["out_index"].toInt()) + QLatin1Char('>') +
+         connection["in_id"].toString() + QLatin1Char(':') +
+         QString::number(connection["in_index"].toInt());
+}
+
+}
+
+bool
+CompressedScene::
+isCompressed(QByteArray const& data)
+{
+  return data.size() >= int(HeaderSize) &&
+         std::memcmp(data.constData(), Magic, sizeof(Magic)) == 0;
+}
+
+
+QByteArray
+CompressedScene::
+fromJson(QJsonObject const& scene, int nodesPerChunk, int compressionLevel)
+{
+  nodesPerChunk = std::max(nodesPerChunk, 1);
+
+  QJsonArray const nodes = scene["nodes"].toArray();
+
+  // order the nodes spatially
+
+  struct Placed
+  {
+    std::uint64_t key;
+    int           index;
+    QPointF       position;
+  };
+
+  std::vector<Placed> placed;
+  placed.reserve(nodes.size());
+
+  for (int i = 0; i < nodes.size(); ++i)
+  {
+    QPointF const position = nodePosition(nodes[i].toObject());
+    placed.push_back(Placed{zOrder(position), i, position});
+  }
+
+  std::sort(placed.begin(), placed.end(),
+            [](Placed const& a, Placed const& b) { return a.key < b.key; });
+
+  // cut into chunks and compress them in parallel
+
+  struct PendingChunk
+  {
+    std::size_t begin;
+    std::size_t end;
+    QRectF      bounds;
+    QJsonArray  nodes;
+    QJsonArray  connections;
+    QByteArray  data;
+  };
+
+  std::vector<PendingChunk> chunks;
+
+  // chunk of every node, by id
+  QHash<QString, std::size_t> chunkOf;
+  chunkOf.reserve(nodes.size());
+
+  for (std::size_t begin = 0; begin < placed.size(); begin += std::size_t(nodesPerChunk))
+  {
+    std::size_t const end = std::min(placed.size(), begin + std::size_t(nodesPerChunk));
+
+    double left  = std::numeric_limits<double>::max(), top    = left;
+    double right = std::numeric_limits<double>::lowest(), bottom = right;
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      left   = std::min(left, placed[i].position.x());
+      top    = std::min(top, placed[i].position.y());
+      right  = std::max(right, placed[i].position.x());
+      bottom = std::max(bottom, placed[i].position.y());
+    }
+
+    QJsonArray chunkNodes;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      QJsonObject const node = nodes[placed[i].index].toObject();
+
+      chunkOf.insert(node["id"].toString(), chunks.size());
+      chunkNodes.append(node);
+    }
+
+    chunks.push_back(PendingChunk{begin, end, QRectF(QPointF(left, top), QPointF(right, bottom)),
+                                  chunkNodes, {}, {}});
+  }
+
+  // a connection goes with the chunks of both of its nodes, so reading a
+  // region finds every connection touching it; those touching no node
+  // stay in the connections section
+  QJsonArray looseConnections;
+
+  for (QJsonValue const& value : scene["connections"].toArray())
+  {
+    QJsonObject const connection = value.toObject();
+
+    auto const outChunk = chunkOf.constFind(connection["out_id"].toString());
+    auto const inChunk  = chunkOf.constFind(connection["in_id"].toString());
+
+    if (outChunk == chunkOf.constEnd() && inChunk == chunkOf.constEnd())
+    {
+      looseConnections.append(connection);
+      continue;
+    }
+
+    if (inChunk != chunkOf.constEnd())
+      chunks[*inChunk].connections.append(connection);
+
+    if (outChunk != chunkOf.constEnd() && (inChunk == chunkOf.constEnd() || *outChunk != *inChunk))
+      chunks[*outChunk].connections.append(connection);
+  }
+
+  QtConcurrent::blockingMap(chunks, [compressionLevel](PendingChunk& chunk) {
+    QJsonObject chunkJson;
+    chunkJson["nodes"]       = chunk.nodes;
+    chunkJson["connections"] = chunk.connections;
+
+    chunk.data = compress(chunkJson, compressionLevel);
+  });
+
+  QJsonObject extra = scene;
+  extra.remove("nodes");
+  extra.remove("connections");
+
+  QByteArray const connections = compress(looseConnections, compressionLevel);
+  QByteArray const extraData   = compress(extra, compressionLevel);
+
+  // write
+
+  QByteArray result;
+  QDataStream stream(&result, QIODevice::WriteOnly);
+  setUp(stream);
+
+  std::uint64_t offset = HeaderSize + IndexEntrySize * chunks.size();
+
+  stream.writeRawData(Magic, sizeof(Magic));
+  stream << quint16(Version) << quint16(0) << quint32(chunks.size());
+
+  stream << quint64(offset) << quint32(connections.size());
+  offset += std::uint64_t(connections.size());
+
+  stream << quint64(offset) << quint32(extraData.size());
+  offset += std::uint64_t(extraData.size());
+
+  for (auto const& chunk : chunks)
+  {
+    stream << quint64(offset) << quint32(chunk.data.size()) << quint32(chunk.end - chunk.begin)
+           << chunk.bounds.left() << chunk.bounds.top()
+           << chunk.bounds.right() << chunk.bounds.bottom();
+
+    offset += std::uint64_t(chunk.data.size());
+  }
+
+  stream.writeRawData(connections.constData(), connections.size());
+  stream.writeRawData(extraData.constData(), extraData.size());
+
+  for (auto const& chunk : chunks)
+    stream.writeRawData(chunk.data.constData(), chunk.data.size());
+
+  return result;
+}
+
+
+QJsonObject
+CompressedScene::
+toJson(QByteArray const& data)
+{
+  CompressedSceneReader const reader(data);
+
+  if (!reader.isValid())
+    return QJsonObject();
+
+  return reader.scene();
+}
+
+//------------------------------------------------------------------------------
+
+CompressedSceneReader::
+CompressedSceneReader(QByteArray const& data)
+  : _data(data)
+{
+  if (!CompressedScene::isCompressed(_data))
+    return;
+
+  QDataStream stream(_data);
+  setUp(stream);
+
+  stream.skipRawData(sizeof(CompressedScene::Magic));
+
+  quint16 version, flags;
+  quint32 chunkCount;
+  quint64 connectionsOffset, extraOffset;
+  quint32 connectionsLength, extraLength;
+
+  stream >> version >> flags >> chunkCount
+         >> connectionsOffset >> connectionsLength
+         >> extraOffset >> extraLength;
+
+  if (stream.status() != QDataStream::Ok ||
+      version != CompressedScene::Version ||
+      chunkCount > (std::size_t(_data.size()) - HeaderSize) / IndexEntrySize)
+    return;
+
+  _connectionsOffset = connectionsOffset;
+  _connectionsLength = connectionsLength;
+  _extraOffset       = extraOffset;
+  _extraLength       = extraLength;
+
+  _chunks.reserve(chunkCount);
+
+  for (quint32 i = 0; i < chunkCount; ++i)
+  {
+    quint64 offset;
+    quint32 length, nodeCount;
+    double  left, top, right, bottom;
+
+    stream >> offset >> length >> nodeCount >> left >> top >> right >> bottom;
+
+    _chunks.push_back(Chunk{offset, length, nodeCount,
+                            QRectF(QPointF(left, top), QPointF(right, bottom))});
+  }
+
+  _valid = stream.status() == QDataStream::Ok;
+}
+
+
+QJsonArray
+CompressedSceneReader::
+nodes(std::size_t chunk) const
+{
+  return chunkJson(chunk)["nodes"].toArray();
+}
+
+
+QJsonArray
+CompressedSceneReader::
+connections(std::size_t chunk) const
+{
+  return chunkJson(chunk)["connections"].toArray();
+}
+
+
+QJsonArray
+CompressedSceneReader::
+connections() const
+{
+  std::vector<std::size_t> all(_chunks.size());
+  for (std::size_t i = 0; i < all.size(); ++i)
+    all[i] = i;
+
+  QJsonArray connectionsJson = looseConnections();
+  QSet<QString> seen;
+
+  for (QJsonObject const& chunk : inflate(all))
+  {
+    for (QJsonValue const& value : chunk["connections"].toArray())
+    {
+      QString const key = connectionKey(value.toObject());
+
+      if (!seen.contains(key))
+      {
+        seen.insert(key);
+        connectionsJson.append(value);
+      }
+    }
+  }
+
+  return connectionsJson;
+}
+
+
+QJsonObject
+CompressedSceneReader::
+extra() const
+{
+  return QJsonDocument::fromJson(section(_extraOffset, _extraLength)).object();
+}
+
+
+QJsonObject
+CompressedSceneReader::
+region(QRectF const& region, QJsonArray* crossing) const
+{
+  QJsonObject scene = extra();
+
+  if (!_valid)
+    return scene;
+
+  std::vector<std::size_t> overlapping;
+
+  for (std::size_t i = 0; i < _chunks.size(); ++i)
+  {
+    QRectF const& bounds = _chunks[i].bounds;
+
+    // bounds of a single node have no area, compare edges
+    if (bounds.left() <= region.right() && bounds.right() >= region.left() &&
+        bounds.top() <= region.bottom() && bounds.bottom() >= region.top())
+      overlapping.push_back(i);
+  }
+
+  std::vector<QJsonObject> const chunks = inflate(overlapping);
+
+  QJsonArray  nodesJson;
+  QSet<QString> ids;
+
+  for (QJsonObject const& chunk : chunks)
+  {
+    for (QJsonValue const& value : chunk["nodes"].toArray())
+    {
+      QJsonObject const node = value.toObject();
+
+      if (region.contains(nodePosition(node)))
+      {
+        ids.insert(node["id"].toString());
+        nodesJson.append(node);
+      }
+    }
+  }
+
+  // every connection touching the region is in the chunks of its nodes,
+  // those with both ends in different chunks twice
+  QJsonArray connectionsJson;
+  QSet<QString> seen;
+
+  for (QJsonObject const& chunk : chunks)
+  {
+    for (QJsonValue const& value : chunk["connections"].toArray())
+    {
+      QJsonObject const connection = value.toObject();
+
+      bool const outInside = ids.contains(connection["out_id"].toString());
+      bool const inInside  = ids.contains(connection["in_id"].toString());
+
+      if (!outInside && !inInside)
+        continue;
+
+      QString const key = connectionKey(connection);
+
+      if (seen.contains(key))
+        continue;
+
+      seen.insert(key);
+
+      if (outInside && inInside)
+        connectionsJson.append(connection);
+      else if (crossing)
+        crossing->append(connection);
+    }
+  }
+
+  scene["nodes"]       = nodesJson;
+  scene["connections"] = connectionsJson;
+
+  return scene;
+}
+
+
+QJsonObject
+CompressedSceneReader::
+scene() const
+{
+  QJsonObject scene = extra();
+
+  std::vector<std::size_t> all(_chunks.size());
+  for (std::size_t i = 0; i < all.size(); ++i)
+    all[i] = i;
+
+  QJsonArray nodesJson;
+  QJsonArray connectionsJson = looseConnections();
+  QSet<QString> seen;
+
+  for (QJsonObject const& chunk : inflate(all))
+  {
+    for (QJsonValue const& value : chunk["nodes"].toArray())
+      nodesJson.append(value);
+
+    for (QJsonValue const& value : chunk["connections"].toArray())
+    {
+      QString const key = connectionKey(value.toObject());
+
+      if (!seen.contains(key))
+      {
+        seen.insert(key);
+        connectionsJson.append(value);
+      }
+    }
+  }
+
+  scene["nodes"]       = nodesJson;
+  scene["connections"] = connectionsJson;
+
+  return scene;
+}
+
+
+QJsonObject
+CompressedSceneReader::
+chunkJson(std::size_t chunk) const
+{
+  Q_ASSERT(chunk < _chunks.size());
+
+  return QJsonDocument::fromJson(section(_chunks[chunk].offset, _chunks[chunk].length)).object();
+}
+
+
+QJsonArray
+CompressedSceneReader::
+looseConnections() const
+{
+  return QJsonDocument::fromJson(section(_connectionsOffset, _connectionsLength)).array();
+}
+
+
+QByteArray
+CompressedSceneReader::
+section(std::uint64_t offset, std::uint32_t length) const
+{
+  if (offset > std::uint64_t(_data.size()) ||
+      length > std::uint64_t(_data.size()) - offset)
+    return QByteArray();
+
+  return qUncompress(reinterpret_cast<uchar const*>(_data.constData() + offset), int(length));
+}
+
+
+std::vector<QJsonObject>
+CompressedSceneReader::
+inflate(std::vector<std::size_t> const& chunks) const
+{
+  struct Inflated
+  {
+    std::size_t chunk;
+    QJsonObject json;
+  };
+
+  std::vector<Inflated> inflated;
+  inflated.reserve(chunks.size());
+
+  for (std::size_t chunk : chunks)
+    inflated.push_back(Inflated{chunk, QJsonObject()});
+
+  QtConcurrent::blockingMap(inflated, [this](Inflated& item) {
+    item.json = chunkJson(item.chunk);
+  });
+
+  std::vector<QJsonObject> result;
+  result.reserve(inflated.size());
+
+  for (auto& item : inflated)
+    result.push_back(std::move(item.json));
+
+  return result;
+}
+}
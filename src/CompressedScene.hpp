@@ -0,0 +1,141 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <QtCore/QRectF>
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+
+#include "Export.hpp"
+
+namespace QtNodes
+{
+
+/// Compressed scene container, for shipping and archiving scenes.
+///
+/// Nodes are sorted along a Z-order curve of their positions and cut into
+/// chunks, each compressed on its own with `qCompress`. An index stores
+/// every chunk's location, node count and bounding box. This means chunks
+/// can be decompressed in parallel, and a region can be read without
+/// inflating the chunks outside it. A connection is stored with the chunks
+/// of both of its nodes. The other top level keys, and connections between
+/// nodes missing from the scene, are compressed separately.
+///
+/// All integers are little endian.
+///
+///     header   magic "QNSZ", u16 version, u16 flags, u32 chunk count,
+///              u64 offset + u32 length of the connections and of the
+///              extra section
+///     index    per chunk: u64 offset, u32 length, u32 node count,
+///              f64 left, top, right, bottom of the node positions
+///     data     the compressed sections; a chunk is a compact JSON object
+///              with the "nodes" and "connections" arrays of the layout of
+///              `DataFlowScene::saveToMemory`
+namespace CompressedScene
+{
+
+constexpr char          Magic[4] = {'Q', 'N', 'S', 'Z'};
+constexpr std::uint16_t Version  = 2;
+
+constexpr int DefaultNodesPerChunk = 256;
+
+NODE_EDITOR_PUBLIC bool
+isCompressed(QByteArray const& data);
+
+/// Compresses a scene in the JSON layout
+NODE_EDITOR_PUBLIC QByteArray
+fromJson(QJsonObject const& scene,
+         int nodesPerChunk = DefaultNodesPerChunk,
+         int compressionLevel = -1);
+
+/// Inflates every chunk, in parallel, into the JSON layout. Returns an empty
+/// object if `data` is not a valid compressed scene.
+NODE_EDITOR_PUBLIC QJsonObject
+toJson(QByteArray const& data);
+
+}
+
+
+/// Reads a compressed scene in place; the data must outlive the reader
+class NODE_EDITOR_PUBLIC CompressedSceneReader
+{
+public:
+
+  struct Chunk
+  {
+    std::uint64_t offset;
+    std::uint32_t length;
+    std::uint32_t nodeCount;
+    QRectF        bounds;
+  };
+
+public:
+
+  explicit
+  CompressedSceneReader(QByteArray const& data);
+
+  bool
+  isValid() const { return _valid; }
+
+  std::vector<Chunk> const&
+  chunks() const { return _chunks; }
+
+  /// Nodes of one chunk, or an empty array if it is corrupt
+  QJsonArray
+  nodes(std::size_t chunk) const;
+
+  /// Connections touching the nodes of one chunk
+  QJsonArray
+  connections(std::size_t chunk) const;
+
+  /// All connections, every chunk is inflated
+  QJsonArray
+  connections() const;
+
+  QJsonObject
+  extra() const;
+
+  /// The scene restricted to nodes positioned in `region` and connections
+  /// between them. Only chunks overlapping `region` are inflated.
+  /// Connections with one end outside `region` go to `crossing`.
+  QJsonObject
+  region(QRectF const& region, QJsonArray* crossing = nullptr) const;
+
+  /// The whole scene, chunks inflated in parallel
+  QJsonObject
+  scene() const;
+
+private:
+
+  QByteArray
+  section(std::uint64_t offset, std::uint32_t length) const;
+
+  /// The object of one chunk, empty if it is corrupt
+  QJsonObject
+  chunkJson(std::size_t chunk) const;
+
+  /// Connections between nodes missing from the chunks
+  QJsonArray
+  looseConnections() const;
+
+  /// Inflates the given chunks in parallel
+  std::vector<QJsonObject>
+  inflate(std::vector<std::size_t> const& chunks) const;
+
+private:
+
+  QByteArray _data;
+
+  bool _valid = false;
+
+  std::vector<Chunk> _chunks;
+
+  std::uint64_t _connectionsOffset = 0;
+  std::uint32_t _connectionsLength = 0;
+  std::uint64_t _extraOffset       = 0;
+  std::uint32_t _extraLength       = 0;
+};
+}
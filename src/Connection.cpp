@@ -14,10 +14,6 @@
 #include "NodeGraphicsObject.hpp"
 #include "NodeDataModel.hpp"
 
-#include "ConnectionState.hpp"
-#include "ConnectionGeometry.hpp"
-#include "ConnectionGraphicsObject.hpp"
-
 namespace QtNodes {
 
 Connection::
@@ -29,11 +25,7 @@ Connection(Node& nodeIn,
   , _inNode(&nodeIn)
   , _outPortIndex(portIndexOut)
   , _inPortIndex(portIndexIn)
-  , _connectionState()
-{
-  setNodeToPort(nodeIn, PortType::In, portIndexIn);
-  setNodeToPort(nodeOut, PortType::Out, portIndexOut);
-}
+{}
 
 
 Connection::
@@ -61,27 +53,6 @@ save() const
   return connectionJson;
 }
 
-void
-Connection::
-setNodeToPort(Node& node,
-              PortType portType,
-              PortIndex portIndex)
-{
-  auto& nodeWeak = getNode(portType);
-
-  nodeWeak = &node;
-
-  if (portType == PortType::Out)
-    _outPortIndex = portIndex;
-  else
-    _inPortIndex = portIndex;
-
-  _connectionState.setNoRequiredPort();
-
-  updated(*this);
-}
-
-
 PortIndex
 Connection::
 getPortIndex(PortType portType) const
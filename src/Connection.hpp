@@ -2,16 +2,12 @@
 
 #include <memory>
 
-#include <QtCore/QObject>
 #include <QtCore/QUuid>
-#include <QVariant>
 
 #include "PortType.hpp"
 #include "NodeData.hpp"
 
 #include "Serializable.hpp"
-#include "ConnectionState.hpp"
-#include "ConnectionGeometry.hpp"
 #include "QUuidStdHash.hpp"
 #include "Export.hpp"
 #include "ConnectionID.hpp"
@@ -23,16 +19,12 @@ namespace QtNodes
 
 class Node;
 class NodeData;
-class ConnectionGraphicsObject;
 
-///
+/// Edge of a DataFlowModel: the two nodes and ports it joins.
+/// Deliberately a plain object, the graph can hold a lot of these.
 class NODE_EDITOR_PUBLIC Connection
-  : public QObject
-  , public Serializable
+  : public Serializable
 {
-
-  Q_OBJECT
-
 public:
 
   Connection(Node& nodeIn,
@@ -75,27 +67,11 @@ public: // data propagation
   propagateEmptyData() const;
 
 private:
-  
-  void 
-  setNodeToPort(Node& node,
-                PortType portType,
-                PortIndex portIndex);
 
   Node* _outNode = nullptr;
   Node* _inNode  = nullptr;
 
   PortIndex _outPortIndex;
   PortIndex _inPortIndex;
-
-private:
-
-  ConnectionState    _connectionState;
-  ConnectionGeometry _connectionGeometry;
-
-  std::unique_ptr<ConnectionGraphicsObject> _connectionGraphicsObject;
-
-signals:
-  void
-  updated(Connection& conn) const;
 };
 }
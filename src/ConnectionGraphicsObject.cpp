@@ -182,7 +182,8 @@ paint(QPainter* painter,
   painter->setClipRect(option->exposedRect);
 
   ConnectionPainter::paint(painter,
-                           *this);
+                           *this,
+                           detailLevel(*option, *painter));
 }
 
 
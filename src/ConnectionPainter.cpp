@@ -65,7 +65,8 @@ getPainterStroke(ConnectionGeometry const& geom)
 void
 ConnectionPainter::
 paint(QPainter* painter,
-      ConnectionGraphicsObject const &cgo)
+      ConnectionGraphicsObject const &cgo,
+      DetailLevel level)
 {
   auto const &connectionStyle =
     StyleCollection::connectionStyle();
@@ -122,13 +123,23 @@ paint(QPainter* painter,
   }
 #endif
 
-  auto cubic = cubicPath(geom);
-
   bool const hovered = geom.hovered();
 
   bool const selected = cgo.isSelected();
 
-  if (hovered || selected)
+  if (level == DetailLevel::Minimal)
+  {
+    // cosmetic pen, one pixel whatever the zoom
+    QPen p(selected ? selectedColor : normalColor, 0.0);
+
+    painter->setPen(p);
+    painter->drawLine(geom.source(), geom.sink());
+    return;
+  }
+
+  auto cubic = cubicPath(geom);
+
+  if ((hovered || selected) && level == DetailLevel::Full)
   {
     QPen p;
 
@@ -170,6 +181,9 @@ paint(QPainter* painter,
     painter->drawPath(cubic);
   }
 
+  if (level != DetailLevel::Full)
+    return;
+
   QPointF const& source = geom.source();
   QPointF const& sink   = geom.sink();
 
@@ -4,6 +4,8 @@
 
 #include <memory>
 
+#include "LevelOfDetail.hpp"
+
 
 namespace QtNodes
 {
@@ -27,9 +29,12 @@ public:
   QPainterPath
   getPainterStroke(ConnectionGeometry const& geom);
 
+  /// Simplified connections have no halo and no end points, minimal ones
+  /// are straight hairlines
   static
   void
   paint(QPainter* painter,
-        ConnectionGraphicsObject const& cgo);
+        ConnectionGraphicsObject const& cgo,
+        DetailLevel level = DetailLevel::Full);
 };
 }
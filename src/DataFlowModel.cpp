@@ -3,17 +3,24 @@
 #include "Node.hpp"
 #include "Connection.hpp"
 
+#include <vector>
+#include <stdexcept>
+
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
 namespace QtNodes {
 
 DataFlowModel::DataFlowModel(std::shared_ptr<DataModelRegistry> registry) 
-: _registry(std::move(registry)) {
+: _registry(std::move(registry))
+, _connectionPool(std::make_shared<MemoryPool>()) {
 }
 
 
 // FlowSceneModel read interface
 QStringList DataFlowModel::modelRegistry() const {
   QStringList list;
-  for (const auto& item : _registry->registeredModels()) {
+  for (const auto& item : _registry->registeredModelCreators()) {
     list << item.first;
   }
   return list;
@@ -27,12 +34,14 @@ QStringList DataFlowModel::modelRegistry() const {
   return {};
 }
 QString DataFlowModel::converterNode(NodeDataType const& lhs, NodeDataType const& rhs) const {
-  auto conv =  _registry->getTypeConverter(lhs.id, rhs.id);
-
-  if (!conv) return {};
-
-  return conv->name();
+  return _registry->getTypeConverterName(lhs.id, rhs.id);
   }
+QStringList DataFlowModel::converterNodeChain(NodeDataType const& lhs, NodeDataType const& rhs) const {
+  return _registry->getTypeConverterChain(lhs.id, rhs.id);
+}
+bool DataFlowModel::typesConvertible(NodeDataType const& lhs, NodeDataType const& rhs) const {
+  return _registry->typesConvertible(lhs.id, rhs.id);
+}
   QList<QUuid> DataFlowModel::nodeUUids() const {
   QList<QUuid> ret;
 
@@ -79,6 +88,14 @@ QWidget* DataFlowModel::nodeWidget(NodeIndex const& index) const {
 
   return node->nodeDataModel()->embeddedWidget();
 }
+bool DataFlowModel::nodeWidgetOwnedByModel(NodeIndex const& index) const {
+  Q_ASSERT(index.isValid());
+
+  auto* node = static_cast<Node*>(index.internalPointer());
+
+  // recycled models keep their widget
+  return _registry->recyclable(node->nodeDataModel()->name());
+}
 bool DataFlowModel::nodeResizable(NodeIndex const& index) const {
   Q_ASSERT(index.isValid());
 
@@ -165,27 +182,59 @@ bool DataFlowModel::removeConnection(NodeIndex const& leftNodeIdx, PortIndex lef
   connID.lPortID = leftPortID;
   connID.rPortID = rightPortID;
 
-  // update the node
-  _connections[connID]->propagateEmptyData();
+  // added during the running bulk load, the views don't know it yet
+  bool const announced = _bulkConnectionSet.erase(connID) == 0;
 
-  // remove it from the nodes
-  auto& leftConns = leftNode->connections(PortType::Out, leftPortID);
-  auto iter = std::find_if(leftConns.begin(), leftConns.end(), [&](Connection* conn){ return conn->id() == connID; });
-  Q_ASSERT(iter != leftConns.end());
-  leftConns.erase(iter);
+  // update the node; in a bulk load those the views know about lose their
+  // input now and pass the change on when the load is evaluated
+  if (!_propagationSuspended || (bulkLoading() && announced)) {
+    deliverDeferredInputs(rightNode);
+    _connections[connID]->propagateEmptyData();
 
-  auto& rightConns = rightNode->connections(PortType::In, rightPortID);
-  iter = std::find_if(rightConns.begin(), rightConns.end(), [&](Connection* conn){ return conn->id() == connID; });
-  Q_ASSERT(iter != rightConns.end());
-  rightConns.erase(iter);
+    if (bulkLoading()) {
+      _bulkInputsChanged.insert(connID.rNodeID);
+    }
+  }
+
+  {
+    QWriteLocker locker(&_graphLock);
+
+    // remove it from the nodes
+    auto& leftConns = leftNode->connections(PortType::Out, leftPortID);
+    auto iter = std::find_if(leftConns.begin(), leftConns.end(), [&](Connection* conn){ return conn->id() == connID; });
+    Q_ASSERT(iter != leftConns.end());
+    leftConns.erase(iter);
+
+    auto& rightConns = rightNode->connections(PortType::In, rightPortID);
+    iter = std::find_if(rightConns.begin(), rightConns.end(), [&](Connection* conn){ return conn->id() == connID; });
+    Q_ASSERT(iter != rightConns.end());
+    rightConns.erase(iter);
+  }
+
+  if (announced) {
+    emit connectionAboutToBeRemoved(leftNodeIdx, leftPortID, rightNodeIdx, rightPortID);
+  }
+
+  // remove it from the map, destroy it outside of the lock
+  SharedConnection removed;
+  {
+    QWriteLocker locker(&_graphLock);
+
+    auto iter = _connections.find(connID);
+    removed = std::move(iter->second);
+    _connections.erase(iter);
 
-  emit connectionAboutToBeRemoved(leftNodeIdx, leftPortID, rightNodeIdx, rightPortID);
+    _graphIndex.connectionRemoved(connID);
+    _reachability.edgeRemoved(connID.lNodeID, connID.rNodeID);
+  }
+  removed.reset();
 
-  // remove it from the map
-  _connections.erase(connID);
+  forgetConnection(connID);
 
   // tell the view
-  emit connectionRemoved(leftNodeIdx, leftPortID, rightNodeIdx, rightPortID);
+  if (announced) {
+    emit connectionRemoved(leftNodeIdx, leftPortID, rightNodeIdx, rightPortID);
+  }
 
   return true;
 }
@@ -202,16 +251,39 @@ bool DataFlowModel::addConnection(NodeIndex const& leftNodeIdx, PortIndex leftPo
   connID.lPortID = leftPortID;
   connID.rPortID = rightPortID;
 
+  if (_connections.count(connID) != 0) {
+    return false;
+  }
+
   // create the connection
-  auto conn = std::make_shared<Connection>(*rightNode, rightPortID, *leftNode, leftPortID);
-  _connections[connID] = conn;
+  auto conn = std::allocate_shared<Connection>(PoolAllocator<Connection>(_connectionPool), *rightNode, rightPortID, *leftNode, leftPortID);
+
+  {
+    QWriteLocker locker(&_graphLock);
 
-  // add it to the nodes
-  leftNode->connections(PortType::Out, leftPortID).push_back(conn.get());
-  rightNode->connections(PortType::In, rightPortID).push_back(conn.get());
+    _connections[connID] = conn;
+
+    // add it to the nodes
+    leftNode->connections(PortType::Out, leftPortID).push_back(conn.get());
+    rightNode->connections(PortType::In, rightPortID).push_back(conn.get());
+
+    _graphIndex.connectionAdded(connID);
+    _reachability.edgeAdded(connID.lNodeID, connID.rNodeID);
+  }
+
+  recordConnection(connID, leftNode->nodeDataModel()->dataType(PortType::Out, leftPortID));
+
+  // a bulk load evaluates and announces everything at its end
+  if (bulkLoading()) {
+    _bulkConnections.push_back(connID);
+    _bulkConnectionSet.insert(connID);
+    return true;
+  }
 
   // update the node
-  _connections[connID]->propagateData(leftNode->nodeDataModel()->outData(leftPortID));
+  if (!_propagationSuspended && !deliverDeferredInputs(rightNode)) {
+    _connections[connID]->propagateData(leftNode->nodeDataModel()->outData(leftPortID));
+  }
 
   // tell the view the connection was added
   emit connectionAdded(leftNodeIdx, leftPortID, rightNodeIdx, rightPortID);
@@ -233,13 +305,49 @@ bool DataFlowModel::removeNode(NodeIndex const& index) {
   }
   #endif
 
-  emit nodeAboutToBeRemoved(index);
+  // added during the running bulk load, the views don't know it yet
+  bool const announced = _bulkNodeSet.erase(index.id()) == 0;
+
+  if (announced) {
+    emit nodeAboutToBeRemoved(index);
+  }
+
+  // the model is not asked anything while the lock is held
+  auto const signature = NodeSignature::of(*node->nodeDataModel());
+
+  // remove it from the map, destroy it outside of the lock
+  UniqueNode removed;
+  {
+    QWriteLocker locker(&_graphLock);
 
-  // remove it from the map
-  _nodes.erase(index.id());
+    auto iter = _nodes.find(index.id());
+    removed = std::move(iter->second);
+    _nodes.erase(iter);
+
+    _graphIndex.nodeRemoved(index.id(), signature);
+    _reachability.nodeRemoved(index.id());
+  }
+
+  _deferredInputs.erase(removed.get());
+
+  // give pooled model types back to the registry for reuse
+  std::unique_ptr<NodeDataModel> recycled;
+  if (_registry->recyclable(removed->nodeDataModel()->name())) {
+    recycled = removed->releaseNodeDataModel();
+    disconnect(recycled.get(), nullptr, this, nullptr);
+  }
+  removed.reset();
+
+  if (recycled) {
+    _registry->recycle(std::move(recycled));
+  }
+
+  forgetNode(index.id());
 
   // tell the view
-  emit nodeRemoved(index.id());
+  if (announced) {
+    emit nodeRemoved(index.id());
+  }
 
   return true;
 }
@@ -255,33 +363,82 @@ QUuid DataFlowModel::addNode(const QString& typeID, QPointF const&) {
 
 Node&
 DataFlowModel::
-addNode(std::unique_ptr<NodeDataModel>&& model) {
+addNode(std::unique_ptr<NodeDataModel>&& model, QUuid const& id, QPointF const& position) {
   // create the UUID
-  QUuid nodeid = QUuid::createUuid();
+  QUuid nodeid = id.isNull() ? QUuid::createUuid() : id;
+
+  // replacing the node would leave its connections pointing at freed memory
+  if (_nodes.count(nodeid) != 0) {
+    throw std::logic_error(std::string("Node id already in use: ") +
+                           nodeid.toString().toLocal8Bit().data());
+  }
   
   // create a node
   auto modelPtr = model.get(); // cache the ptr
   auto node = std::make_unique<Node>(std::move(model), nodeid);
+  node->setPosition(position, false);
 
   // cache the pointer so the connection can be made
   auto nodePtr = node.get();
 
+  // the model is not asked anything while the lock is held
+  auto const signature = NodeSignature::of(*modelPtr);
+
   // add it to the map
-  _nodes[nodeid] = std::move(node);
+  {
+    QWriteLocker locker(&_graphLock);
+
+    _nodes[nodeid] = std::move(node);
+
+    _graphIndex.nodeAdded(nodeid, signature);
+    _reachability.nodeAdded(nodeid);
+  }
+
+  recordNode(nodeid);
+  markStateStale(nodeid);
 
   // connect to the geometry gets updated
-  connect(nodePtr, &Node::positionChanged, this, [this, nodeid](QPointF const&){ nodeMoved(nodeIndex(nodeid)); });
+  connect(nodePtr, &Node::positionChanged, this, [this, nodeid](QPointF const&){
+    recordNode(nodeid);
+    if (announced(nodeid)) {
+      nodeMoved(nodeIndex(nodeid));
+    }
+  });
+
+  // views cache the node description, tell them when validation or the
+  // caption changes
+  auto descriptionChanged = [this, nodeid]{
+    if (announced(nodeid)) {
+      nodeValidationUpdated(nodeIndex(nodeid));
+    }
+  };
+  connect(nodePtr, &Node::validationChanged, this, descriptionChanged);
+  connect(nodePtr, &Node::captionChanged, this, descriptionChanged);
 
   // connect to data changes
-  connect(modelPtr, &NodeDataModel::dataUpdated, this, [nodePtr](PortIndex id) {
+  connect(modelPtr, &NodeDataModel::dataUpdated, this, [this, nodeid, nodePtr](PortIndex id) {
+    // nodes of the running bulk load had their state recorded when added
+    if (announced(nodeid)) {
+      markStateStale(nodeid);
+    }
     nodePtr->onDataUpdated(id);
+    if (_propagationSuspended) {
+      return;
+    }
     for (const auto& conn : nodePtr->connections(PortType::Out, id)) {
-      conn->propagateData(nodePtr->nodeDataModel()->outData(id));
+      if (!deliverDeferredInputs(conn->getNode(PortType::In))) {
+        conn->propagateData(nodePtr->nodeDataModel()->outData(id));
+      }
     }
   });
 
-  // tell the view
-  emit nodeAdded(nodeid);
+  // tell the view, or once the bulk load is done
+  if (bulkLoading()) {
+    _bulkNodes.push_back(nodeid);
+    _bulkNodeSet.insert(nodeid);
+  } else {
+    emit nodeAdded(nodeid);
+  }
   
   return *nodePtr;
 }
@@ -290,12 +447,380 @@ bool DataFlowModel::moveNode(NodeIndex const& index, QPointF newLocation) {
   Q_ASSERT(index.isValid());
 
   auto* node = static_cast<Node*>(index.internalPointer());
-  node->setPosition(newLocation);
 
-  // no need to emit, it's done by the function already
+  if (node->position() == newLocation) {
+    return true;
+  }
+
+  {
+    QWriteLocker locker(&_graphLock);
+    node->setPosition(newLocation, false);
+  }
+
+  // outside of the lock: the view moves its item in response, which calls
+  // back into moveNode
+  emit node->positionChanged(newLocation);
+
   return true;
 }
 
+void DataFlowModel::reserve(std::size_t nodeCount, std::size_t connectionCount) {
+  QWriteLocker locker(&_graphLock);
+
+  _nodes.reserve(nodeCount);
+  _connections.reserve(connectionCount);
+}
+
+void DataFlowModel::beginBulkLoad() {
+  if (_bulkLoadDepth++ == 0) {
+    _propagationSuspended = true;
+  }
+}
+
+void DataFlowModel::endBulkLoad() {
+  Q_ASSERT(_bulkLoadDepth > 0);
+
+  if (_bulkLoadDepth > 1) {
+    --_bulkLoadDepth;
+    return;
+  }
+
+  // only what the load added or changed inputs of, and everything
+  // downstream of that, needs evaluating
+  std::vector<Node*> changed;
+  changed.reserve(_bulkNodeSet.size() + _bulkConnectionSet.size() + _bulkInputsChanged.size());
+
+  for (QUuid const& id : _bulkNodes) {
+    if (_bulkNodeSet.count(id) != 0) {
+      changed.push_back(_nodes[id].get());
+    }
+  }
+  for (ConnectionID const& id : _bulkConnections) {
+    if (_bulkConnectionSet.count(id) != 0) {
+      changed.push_back(_nodes[id.rNodeID].get());
+    }
+  }
+  for (QUuid const& id : _bulkInputsChanged) {
+    auto iter = _nodes.find(id);
+    if (iter != _nodes.end()) {
+      changed.push_back(iter->second.get());
+    }
+  }
+
+  // the new nodes are still quiet, the views read their final state when
+  // they are announced
+  evaluateFrom(changed);
+
+  _bulkLoadDepth = 0;
+  _propagationSuspended = false;
+
+  auto nodes       = std::move(_bulkNodes);
+  auto nodeSet     = std::move(_bulkNodeSet);
+  auto connections = std::move(_bulkConnections);
+  auto connSet     = std::move(_bulkConnectionSet);
+  _bulkNodes.clear();
+  _bulkNodeSet.clear();
+  _bulkConnections.clear();
+  _bulkConnectionSet.clear();
+  _bulkInputsChanged.clear();
+
+  // nodes first, connections refer to them; skip what was removed again
+  for (QUuid const& id : nodes) {
+    if (nodeSet.count(id) != 0) {
+      emit nodeAdded(id);
+    }
+  }
+
+  for (ConnectionID const& id : connections) {
+    if (connSet.count(id) != 0) {
+      emit connectionAdded(nodeIndex(id.lNodeID), id.lPortID, nodeIndex(id.rNodeID), id.rPortID);
+    }
+  }
+}
+
+void DataFlowModel::evaluateAll() {
+  std::vector<Node*> nodes;
+  nodes.reserve(_nodes.size());
+
+  for (auto const& pair : _nodes) {
+    nodes.push_back(pair.second.get());
+  }
+
+  evaluateFrom(nodes);
+}
+
+void DataFlowModel::evaluateFrom(std::vector<Node*> const& changed) {
+  bool const wasSuspended = _propagationSuspended;
+  _propagationSuspended = true;
+
+  // the changed nodes and everything downstream of them
+  std::unordered_set<Node*> affected(changed.begin(), changed.end());
+  std::vector<Node*> nodes(affected.begin(), affected.end());
+
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    Node* node = nodes[i];
+
+    for (PortIndex port = 0; (unsigned)port < node->nodeDataModel()->nPorts(PortType::Out); ++port) {
+      for (Connection* conn : node->connections(PortType::Out, port)) {
+        Node* downstream = conn->getNode(PortType::In);
+
+        if (affected.insert(downstream).second) {
+          nodes.push_back(downstream);
+        }
+      }
+    }
+  }
+
+  // Kahn's algorithm over the connections among them
+  std::unordered_map<Node*, std::size_t> pendingInputs;
+  pendingInputs.reserve(nodes.size());
+
+  std::vector<Node*> ready;
+  ready.reserve(nodes.size());
+
+  for (Node* node : nodes) {
+    std::size_t inputs = 0;
+    for (PortIndex port = 0; (unsigned)port < node->nodeDataModel()->nPorts(PortType::In); ++port) {
+      for (Connection* conn : node->connections(PortType::In, port)) {
+        Node* upstream = conn->getNode(PortType::Out);
+
+        if (affected.count(upstream) != 0) {
+          ++inputs;
+        } else if (_deferredInputs.count(node) == 0) {
+          // unaffected upstream outputs are final already
+          conn->propagateData(upstream->nodeDataModel()->outData(conn->getPortIndex(PortType::Out)));
+        }
+      }
+    }
+
+    if (inputs == 0) {
+      ready.push_back(node);
+    } else {
+      pendingInputs[node] = inputs;
+    }
+  }
+
+  auto evaluate = [&](Node* node) {
+    for (PortIndex port = 0; (unsigned)port < node->nodeDataModel()->nPorts(PortType::Out); ++port) {
+      auto const& outputs = node->connections(PortType::Out, port);
+
+      if (outputs.empty()) {
+        continue;
+      }
+
+      auto data = node->nodeDataModel()->outData(port);
+
+      for (Connection* conn : outputs) {
+        Node* downstream = conn->getNode(PortType::In);
+
+        // runs on restored outputs
+        if (_deferredInputs.count(downstream) == 0) {
+          conn->propagateData(data);
+        }
+
+        auto iter = pendingInputs.find(downstream);
+        if (iter != pendingInputs.end() && --iter->second == 0) {
+          pendingInputs.erase(iter);
+          ready.push_back(downstream);
+        }
+      }
+    }
+  };
+
+  // ready acts as the queue
+  std::size_t next = 0;
+  auto drain = [&] {
+    while (next < ready.size()) {
+      evaluate(ready[next++]);
+    }
+  };
+
+  drain();
+
+  // nodes on cycles, in no particular order
+  while (!pendingInputs.empty()) {
+    Node* node = pendingInputs.begin()->first;
+    pendingInputs.erase(pendingInputs.begin());
+
+    evaluate(node);
+    drain();
+  }
+
+  _propagationSuspended = wasSuspended;
+}
+
+bool DataFlowModel::restoreOutputs(NodeIndex const& index, std::vector<std::shared_ptr<NodeData>> const& outputs) {
+  Q_ASSERT(index.isValid());
+
+  auto* node  = static_cast<Node*>(index.internalPointer());
+  auto* model = node->nodeDataModel();
+
+  if (outputs.size() != model->nPorts(PortType::Out)) {
+    return false;
+  }
+
+  // check everything before the model is touched
+  for (PortIndex port = 0; (std::size_t)port < outputs.size(); ++port) {
+    if (outputs[port] && outputs[port]->type().id != model->dataType(PortType::Out, port).id) {
+      return false;
+    }
+  }
+
+  std::vector<std::shared_ptr<NodeData>> previous;
+  previous.reserve(outputs.size());
+
+  for (PortIndex port = 0; (std::size_t)port < outputs.size(); ++port) {
+    previous.push_back(model->outData(port));
+
+    if (!model->restoreOutData(port, outputs[port])) {
+      // put back what the ports already taken had, so the node is left
+      // as it was rather than half restored
+      for (PortIndex restored = 0; restored < port; ++restored) {
+        model->restoreOutData(restored, previous[restored]);
+      }
+      return false;
+    }
+  }
+
+  _deferredInputs.insert(node);
+
+  return true;
+}
+
+bool DataFlowModel::deliverDeferredInputs(Node* node) {
+  if (_deferredInputs.erase(node) == 0) {
+    return false;
+  }
+
+  for (PortIndex port = 0; (unsigned)port < node->nodeDataModel()->nPorts(PortType::In); ++port) {
+    for (Connection* conn : node->connections(PortType::In, port)) {
+      Node* upstream = conn->getNode(PortType::Out);
+      conn->propagateData(upstream->nodeDataModel()->outData(conn->getPortIndex(PortType::Out)));
+    }
+  }
+
+  return true;
+}
+
+GraphSnapshot DataFlowModel::snapshot() const {
+  // models can only be saved on their own thread
+  if (QThread::currentThread() == thread()) {
+    const_cast<DataFlowModel*>(this)->saveStaleStates();
+  }
+
+  QMutexLocker locker(&_snapshotMutex);
+
+  return GraphSnapshot(_snapshotNodes, _snapshotConnections, _snapshotVersion);
+}
+
+void DataFlowModel::commitNodeState(NodeIndex const& index) {
+  Q_ASSERT(index.isValid());
+
+  markStateStale(index.id());
+}
+
+void DataFlowModel::commitNodeState(NodeIndex const& index, QJsonObject const& modelState) {
+  Q_ASSERT(index.isValid());
+
+  recordNode(index.id(), &modelState);
+}
+
+void DataFlowModel::watchNodeStates() {
+  ++_stateWatchers;
+}
+
+void DataFlowModel::unwatchNodeStates() {
+  Q_ASSERT(_stateWatchers > 0);
+
+  --_stateWatchers;
+}
+
+void DataFlowModel::markStateStale(QUuid const& id) {
+  _staleStates.insert(id);
+
+  // unwatched, the next snapshot saves it; watched, one save per node and
+  // event loop turn, however often its data changes
+  if (_stateWatchers > 0 && !_staleSaveScheduled) {
+    _staleSaveScheduled = true;
+    QTimer::singleShot(0, this, [this] {
+      _staleSaveScheduled = false;
+      saveStaleStates();
+    });
+  }
+}
+
+void DataFlowModel::saveStaleStates() {
+  if (_staleStates.empty()) {
+    return;
+  }
+
+  auto stale = std::move(_staleStates);
+  _staleStates.clear();
+
+  for (QUuid const& id : stale) {
+    QJsonObject const modelState = _nodes[id]->nodeDataModel()->save();
+    recordNode(id, &modelState);
+  }
+}
+
+void DataFlowModel::recordNode(QUuid const& id, QJsonObject const* modelState) {
+  auto iter = _nodes.find(id);
+  Q_ASSERT(iter != _nodes.end());
+
+  auto const& node = *iter->second;
+
+  auto record = std::make_shared<NodeRecord>();
+  record->id        = id;
+  record->modelName = node.nodeDataModel()->name();
+  record->position  = node.position();
+
+  // a state at hand supersedes a pending save
+  if (modelState) {
+    record->modelState = *modelState;
+    _staleStates.erase(id);
+  }
+
+  {
+    QMutexLocker locker(&_snapshotMutex);
+
+    if (!modelState) {
+      if (auto previous = _snapshotNodes.find(id)) {
+        record->modelState = (*previous)->modelState;
+      }
+    }
+
+    _snapshotNodes = _snapshotNodes.insert(id, std::move(record));
+    ++_snapshotVersion;
+  }
+
+  if (modelState) {
+    emit nodeStateCommitted(id);
+  }
+}
+
+void DataFlowModel::forgetNode(QUuid const& id) {
+  _staleStates.erase(id);
+
+  QMutexLocker locker(&_snapshotMutex);
+
+  _snapshotNodes = _snapshotNodes.erase(id);
+  ++_snapshotVersion;
+}
+
+void DataFlowModel::recordConnection(ConnectionID const& id, NodeDataType const& dataType) {
+  QMutexLocker locker(&_snapshotMutex);
+
+  _snapshotConnections = _snapshotConnections.insert(id, dataType);
+  ++_snapshotVersion;
+}
+
+void DataFlowModel::forgetConnection(ConnectionID const& id) {
+  QMutexLocker locker(&_snapshotMutex);
+
+  _snapshotConnections = _snapshotConnections.erase(id);
+  ++_snapshotVersion;
+}
+
 void DataFlowModel::nodeDoubleClicked(NodeIndex const& index, QPoint const&) {
   emit nodeDoubleClickedSignal(*_nodes[index.id()]);
 }
@@ -6,31 +6,126 @@
 #include "Node.hpp"
 #include "Connection.hpp"
 #include "QUuidStdHash.hpp"
+#include "GraphSnapshot.hpp"
+#include "MemoryPool.hpp"
+#include "GraphIndex.hpp"
+#include "ReachabilityCache.hpp"
 
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <memory>
 
 #include <QUuid>
+#include <QReadWriteLock>
+#include <QMutex>
 
 namespace QtNodes {
 
 // default model class
+//
+// Threading: the model is mutated only from the thread it lives in. Every
+// mutation holds `graphLock()` for writing while it changes `_nodes`,
+// `_connections`, node positions or the per-port connection lists, so other
+// threads may traverse that structure while holding the lock for reading.
+// The owning thread reads without locking and must never take the lock
+// itself. The NodeDataModels are not covered by the lock, and no signal is
+// emitted and no NodeDataModel is called while it is held.
 class DataFlowModel : public FlowSceneModel {
   Q_OBJECT
 public:
 
   DataFlowModel(std::shared_ptr<DataModelRegistry> reg);
 
+  /// Lock guarding the graph structure, see the class comment
+  QReadWriteLock& graphLock() const { return _graphLock; }
+
+  /// Immutable copy of the current graph in O(1), callable from any thread.
+  /// Node states are saved lazily on the model's thread: there a snapshot
+  /// is always current, other threads see the states as of the last
+  /// snapshot taken there, or of the last turn of its event loop while the
+  /// states are watched.
+  GraphSnapshot snapshot() const;
+
+  /// While watched, stale node states are saved on the next turn of the
+  /// event loop and announced through `nodeStateCommitted`; otherwise they
+  /// are only saved by `snapshot()`. Calls nest.
+  void watchNodeStates();
+
+  void unwatchNodeStates();
+
+  /// Marks the recorded `NodeDataModel::save()` of a node as stale, see
+  /// `watchNodeStates`. Done on every `dataUpdated`; call it after changing
+  /// the state of a model by other means.
+  void commitNodeState(NodeIndex const& index);
+
+  /// Records the result of `NodeDataModel::save()` at hand, the node is
+  /// not saved again for it
+  void commitNodeState(NodeIndex const& index, QJsonObject const& modelState);
+
+  /// Preallocates room for the given number of nodes and connections,
+  /// avoids rehashing during large loads
+  void reserve(std::size_t nodeCount, std::size_t connectionCount);
+
+  /// Starts a bulk load: until the matching `endBulkLoad()` no data is
+  /// propagated, and nodes and connections added are not announced, so
+  /// views build no graphics for the intermediate states. Changes to what
+  /// existed before are signalled as usual. Calls nest.
+  void beginBulkLoad();
+
+  /// Ends a bulk load. The outermost call evaluates, like `evaluateAll()`,
+  /// the nodes the load added or changed the inputs of and everything
+  /// downstream of them, then emits `nodeAdded` and `connectionAdded` for
+  /// everything added during the load that is still there.
+  void endBulkLoad();
+
+  bool bulkLoading() const { return _bulkLoadDepth > 0; }
+
+  /// Pushes every node's outputs through its connections in topological
+  /// order, so each node sees its final inputs before its outputs are
+  /// read. Outputs are not propagated any further while this runs.
+  void evaluateAll();
+
+  /// Same for `changed` and everything downstream of it; nodes upstream
+  /// are taken as final and only deliver their current outputs
+  void evaluateFrom(std::vector<Node*> const& changed);
+
+  /// Gives a node's model previously computed outputs, one per output port,
+  /// through `NodeDataModel::restoreOutData`. If the model takes them all,
+  /// its inputs are left out of `evaluateAll()` and only delivered once one
+  /// of them changes, so the node is not recomputed until then. Otherwise
+  /// the model keeps the outputs it had.
+  bool restoreOutputs(NodeIndex const& index, std::vector<std::shared_ptr<NodeData>> const& outputs);
+
+  /// Counters and lookups by model name, port data type, unconnected
+  /// inputs and fan-out, maintained on every mutation
+  GraphIndex const& graphIndex() const { return _graphIndex; }
+
+  /// Every node whose inputs depend, directly or transitively, on `id`.
+  /// Cached between calls and only recomputed for the part of the graph a
+  /// connection change can affect.
+  std::vector<QUuid> descendants(QUuid const& id) const { return _reachability.descendants(id); }
+
+  /// Every node `id` depends on, directly or transitively
+  std::vector<QUuid> ancestors(QUuid const& id) const { return _reachability.ancestors(id); }
+
+  /// True if a change in `upstream` propagates to `downstream`
+  bool dependsOn(QUuid const& downstream, QUuid const& upstream) const { return _reachability.reaches(upstream, downstream); }
+
   // FlowSceneModel read interface
   QStringList modelRegistry() const override;
+  std::size_t modelRegistryGeneration() const override { return _registry->generation(); }
   QString nodeTypeCategory(QString const& /*name*/) const override;
   QString converterNode(NodeDataType const& /*lhs*/, NodeDataType const& ) const override;
+  QStringList converterNodeChain(NodeDataType const& lhs, NodeDataType const& rhs) const override;
+  bool typesConvertible(NodeDataType const& lhs, NodeDataType const& rhs) const override;
   QList<QUuid> nodeUUids() const override;
   NodeIndex nodeIndex(const QUuid& ID) const override;
   QString nodeTypeIdentifier(NodeIndex const& index) const override;
   QString nodeCaption(NodeIndex const& index) const override;
   QPointF nodeLocation(NodeIndex const& index) const override;
   QWidget* nodeWidget(NodeIndex const& index) const override;
+  bool nodeWidgetOwnedByModel(NodeIndex const& index) const override;
   bool nodeResizable(NodeIndex const& index) const override;
   NodeValidationState nodeValidationState(NodeIndex const& index) const override;
   QString nodeValidationMessage(NodeIndex const& index) const override;
@@ -46,7 +141,10 @@ public:
   bool addConnection(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const& rightNode, PortIndex rightPortID) override;
   bool removeNode(NodeIndex const& index) override;
   QUuid addNode(const QString& typeID, QPointF const& location) override;
-  Node& addNode(std::unique_ptr<NodeDataModel>&& model);
+  /// Adds a node with the given id, or a fresh one if `id` is null, placed
+  /// at `position` before it is announced. Throws std::logic_error if `id`
+  /// is already in use.
+  Node& addNode(std::unique_ptr<NodeDataModel>&& model, QUuid const& id = QUuid(), QPointF const& position = QPointF());
   bool moveNode(NodeIndex const& index, QPointF newLocation) override;
 
   // notifications
@@ -62,6 +160,10 @@ signals:
   void nodeHoveredEnteredSignal(Node& n, QPoint screenPos);
   void nodeHoveredLeftSignal(Node& n, QPoint screenPos);
 
+  /// The recorded `NodeDataModel::save()` of a node changed, see
+  /// `commitNodeState`
+  void nodeStateCommitted(QUuid const& id);
+
 public:
 
   using SharedConnection = std::shared_ptr<Connection>;
@@ -71,5 +173,66 @@ public:
   std::unordered_map<QUuid, UniqueNode>              _nodes;
   std::shared_ptr<DataModelRegistry>                 _registry;
 
+private:
+
+  /// Without `modelState` the previously recorded state is kept
+  void recordNode(QUuid const& id, QJsonObject const* modelState = nullptr);
+
+  void markStateStale(QUuid const& id);
+
+  void saveStaleStates();
+
+  void forgetNode(QUuid const& id);
+
+  void recordConnection(ConnectionID const& id, NodeDataType const& dataType);
+
+  void forgetConnection(ConnectionID const& id);
+
+  /// False for nodes added during the running bulk load
+  bool announced(QUuid const& id) const { return _bulkNodeSet.count(id) == 0; }
+
+  /// Delivers all inputs of `node` if they were held back by
+  /// `restoreOutputs`, returns whether it did
+  bool deliverDeferredInputs(Node* node);
+
+private:
+
+  // connections are allocated from here rather than one by one
+  std::shared_ptr<MemoryPool> _connectionPool;
+
+  mutable QReadWriteLock _graphLock;
+
+  GraphIndex _graphIndex;
+
+  int _bulkLoadDepth = 0;
+
+  // added during the bulk load, announced at its end in this order
+  std::vector<QUuid>               _bulkNodes;
+  std::unordered_set<QUuid>        _bulkNodeSet;
+  std::vector<ConnectionID>        _bulkConnections;
+  std::unordered_set<ConnectionID> _bulkConnectionSet;
+
+  // known nodes that lost an input during the bulk load
+  std::unordered_set<QUuid>        _bulkInputsChanged;
+
+  // set while data propagation is driven by evaluateAll() or suspended
+  bool _propagationSuspended = false;
+
+  // nodes running on restored outputs, inputs not delivered yet
+  std::unordered_set<Node*> _deferredInputs;
+
+  ReachabilityCache _reachability;
+
+  // persistent copy of the graph, shared with the snapshots handed out
+  mutable QMutex               _snapshotMutex;
+  GraphSnapshot::NodeMap       _snapshotNodes;
+  GraphSnapshot::ConnectionMap _snapshotConnections;
+  std::size_t                  _snapshotVersion = 0;
+
+  // nodes whose recorded state is behind their model, owning thread only
+  std::unordered_set<QUuid> _staleStates;
+  bool                      _staleSaveScheduled = false;
+  int                       _stateWatchers      = 0;
+
 };
 } // namespace QtNodes
\ No newline at end of file
@@ -1,13 +1,163 @@
 #include "DataFlowScene.hpp"
 #include "Connection.hpp"
 #include "DataFlowModel.hpp"
+#include "BinaryScene.hpp"
+#include "CompressedScene.hpp"
+#include "SceneLoader.hpp"
 
+#include <QApplication>
+#include <QClipboard>
+#include <QDebug>
 #include <QFileDialog>
+#include <QMimeData>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
 
 namespace QtNodes {
 
+namespace {
+
+/// Runs `work` on each item, on the global thread pool for the items whose
+/// model serializes thread-safely and on this thread for the others
+template <typename Item, typename Work>
+void serializeNodes(std::vector<Item>& items, Work const& work) {
+  bool const anyThreadSafe = std::any_of(items.begin(), items.end(),
+                                         [](Item const& item) { return item.threadSafe; });
+
+  if (anyThreadSafe) {
+    QtConcurrent::blockingMap(items, [&work](Item& item) {
+      if (item.threadSafe)
+        work(item);
+    });
+  }
+
+  for (auto& item : items) {
+    if (!item.threadSafe)
+      work(item);
+  }
+}
+
+/// Keeps `model` in a bulk load for the lifetime of the guard
+class BulkLoad {
+public:
+  explicit BulkLoad(DataFlowModel& model) : _model(model) { _model.beginBulkLoad(); }
+  ~BulkLoad() { _model.endBulkLoad(); }
+
+private:
+  DataFlowModel& _model;
+};
+
+struct SavedNode {
+  Node const* node;
+  bool        threadSafe;
+  QJsonObject json;
+  QString     modelName;
+  QByteArray  blob;
+};
+
+std::vector<SavedNode> nodesToSave(std::unordered_map<QUuid, std::unique_ptr<Node>> const& nodes) {
+  std::vector<SavedNode> items;
+  items.reserve(nodes.size());
+
+  for (auto const& pair : nodes) {
+    Node const* node = pair.second.get();
+    items.push_back(SavedNode{node, node->nodeDataModel()->serializationThreadSafe(), {}, {}, {}});
+  }
+
+  return items;
+}
+
+std::vector<SavedNode> nodesToSave(std::vector<Node const*> const& nodes) {
+  std::vector<SavedNode> items;
+  items.reserve(nodes.size());
+
+  for (Node const* node : nodes) {
+    items.push_back(SavedNode{node, node->nodeDataModel()->serializationThreadSafe(), {}, {}, {}});
+  }
+
+  return items;
+}
+
+struct RestoredNode {
+  QUuid       id;
+  QPointF     position;
+  QJsonObject modelJson;
+  std::size_t entry; // in the binary reader
+
+  std::unique_ptr<NodeDataModel> model;
+  bool                           threadSafe;
+  QJsonObject                    savedState;
+};
+
+/// Creates the models of `items`, restores them in parallel where they
+/// allow it, then adds them to `model` here. `modelState` gives the state
+/// of an item to restore and may be called from any thread.
+///
+/// Items whose id the model already uses get a fresh one, recorded in
+/// `idMap` for their connections, as a paste does. Repeated ids within
+/// `items` get one too but stay unmapped, connections go to the first.
+template <typename ModelState>
+void restoreNodes(DataFlowModel& model,
+                  std::vector<RestoredNode>& items,
+                  std::vector<QString> const& modelNames,
+                  ModelState const& modelState,
+                  std::unordered_map<QUuid, QUuid>& idMap) {
+  std::unordered_set<QUuid> used;
+  used.reserve(items.size());
+
+  for (auto& item : items) {
+    bool const repeated = item.id.isNull() || !used.insert(item.id).second;
+
+    if (!repeated && !model.nodeIndex(item.id).isValid())
+      continue;
+
+    QUuid const fresh = QUuid::createUuid();
+
+    if (!repeated)
+      idMap[item.id] = fresh;
+
+    item.id = fresh;
+  }
+
+  // models may build widgets, create them all here first; this also fails
+  // before anything is added if a name is unknown
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    auto& item = items[i];
+
+    item.model = model._registry->create(modelNames[i]);
+
+    if (!item.model)
+      throw std::logic_error(std::string("No registered model with name ") +
+                             modelNames[i].toLocal8Bit().data());
+
+    item.threadSafe = item.model->serializationThreadSafe();
+  }
+
+  serializeNodes(items, [&modelState](RestoredNode& item) {
+    item.model->restore(modelState(item));
+
+    // what snapshots record, saves doing it again on this thread
+    item.savedState = item.model->save();
+  });
+
+  for (auto& item : items) {
+    auto& node  = model.addNode(std::move(item.model), item.id, item.position);
+    auto  index = model.nodeIndex(node.id());
+
+    // the saved state replaces the save addNode left pending
+    model.commitNodeState(index, item.savedState);
+  }
+}
+
+}
+
 DataFlowScene::DataFlowScene(std::shared_ptr<DataModelRegistry> registry) : FlowScene(new DataFlowModel(std::move(registry))) {
   _dataFlowModel = static_cast<DataFlowModel*>(model());
 
@@ -79,8 +229,14 @@ restoreConnection(QJsonObject const &connectionJson)
   
   connId.lPortID = portIndexOut;
   connId.rPortID = portIndexIn;
+
+  auto nodeOut = _dataFlowModel->nodeIndex(nodeOutId);
+  auto nodeIn  = _dataFlowModel->nodeIndex(nodeInId);
+
+  if (!nodeOut.isValid() || !nodeIn.isValid())
+    return nullptr;
   
-  if (!_dataFlowModel->addConnection(_dataFlowModel->nodeIndex(nodeOutId), connId.lPortID, _dataFlowModel->nodeIndex(nodeInId), connId.rPortID)) 
+  if (!_dataFlowModel->addConnection(nodeOut, connId.lPortID, nodeIn, connId.rPortID)) 
     return nullptr;
 
   return _dataFlowModel->_connections[connId];
@@ -104,18 +260,33 @@ Node&
 DataFlowScene::
 restoreNode(QJsonObject const& nodeJson)
 {
-  QString modelName = nodeJson["model"].toObject()["name"].toString();
+  QJsonObject const modelJson    = nodeJson["model"].toObject();
+  QJsonObject const positionJson = nodeJson["position"].toObject();
 
-  auto uuid = _dataFlowModel->addNode(modelName, {});
-  
-  if (uuid.isNull())
+  return restoreNode(QUuid(nodeJson["id"].toString()),
+                     modelJson["name"].toString(),
+                     QPointF(positionJson["x"].toDouble(), positionJson["y"].toDouble()),
+                     modelJson);
+}
+
+Node&
+DataFlowScene::
+restoreNode(QUuid const& id,
+            QString const& modelName,
+            QPointF const& position,
+            QJsonObject const& modelJson)
+{
+  auto model = _dataFlowModel->_registry->create(modelName);
+
+  if (!model)
     throw std::logic_error(std::string("No registered model with name ") +
                            modelName.toLocal8Bit().data());
 
-  auto& node = *_dataFlowModel->_nodes[uuid];
-  node.restore(nodeJson);
+  // restored and placed before the views hear of it
+  model->restore(modelJson);
 
-  return node;
+  // keep the saved id, connections refer to it
+  return _dataFlowModel->addNode(std::move(model), id, position);
 }
 
 void 
@@ -135,6 +306,8 @@ void
 DataFlowScene::
 setRegistry(std::shared_ptr<DataModelRegistry> registry) {
   _dataFlowModel->_registry = std::move(registry);
+
+  emit _dataFlowModel->modelRegistryChanged();
 }
 
 void
@@ -170,13 +343,15 @@ DataFlowScene::
 iterateOverNodeDataDependentOrder(std::function<void(NodeDataModel*)> visitor) {
   std::set<QUuid> visitedNodesSet;
 
+  // read the connections from the nodes, their graphics may not exist
+
   //A leaf node is a node with no input ports, or all possible input ports empty
   auto isNodeLeaf =
-    [](NodeGraphicsObject const &node, NodeDataModel const &model)
+    [](Node &node, NodeDataModel const &model)
     {
       for (size_t i = 0; i < model.nPorts(PortType::In); ++i)
       {
-        auto connections = node.nodeState().connections(PortType::In, i);
+        auto const& connections = node.connections(PortType::In, i);
         if (!connections.empty())
         {
           return false;
@@ -189,10 +364,10 @@ iterateOverNodeDataDependentOrder(std::function<void(NodeDataModel*)> visitor) {
   //Iterate over "leaf" nodes
   for (auto const &_node : _dataFlowModel->_nodes)
   {
-    auto const &node = *_node.second;
-    auto model       = node.nodeDataModel();
+    auto &node = *_node.second;
+    auto model = node.nodeDataModel();
 
-    if (isNodeLeaf(*nodeGraphicsObject(node.id()), *model))
+    if (isNodeLeaf(node, *model))
     {
       visitor(model);
       visitedNodesSet.insert(node.id());
@@ -200,15 +375,15 @@ iterateOverNodeDataDependentOrder(std::function<void(NodeDataModel*)> visitor) {
   }
 
   auto areNodeInputsVisitedBefore =
-    [&](NodeGraphicsObject const &node, NodeDataModel const &model)
+    [&](Node &node, NodeDataModel const &model)
     {
       for (size_t i = 0; i < model.nPorts(PortType::In); ++i)
       {
-        auto connections = node.nodeState().connections(PortType::In, i);
+        auto const& connections = node.connections(PortType::In, i);
 
-        for (auto& conn : connections)
+        for (auto conn : connections)
         {
-          if (visitedNodesSet.find(conn->node(PortType::Out).id()) == visitedNodesSet.end())
+          if (visitedNodesSet.find(conn->getNode(PortType::Out)->id()) == visitedNodesSet.end())
           {
             return false;
           }
@@ -229,7 +404,7 @@ iterateOverNodeDataDependentOrder(std::function<void(NodeDataModel*)> visitor) {
 
       auto model = node->nodeDataModel();
 
-      if (areNodeInputsVisitedBefore(*nodeGraphicsObject(node->id()), *model))
+      if (areNodeInputsVisitedBefore(*node, *model))
       {
         visitor(model);
         visitedNodesSet.insert(node->id());
@@ -243,6 +418,10 @@ DataFlowScene::
 getNodeSize(const Node& node) const {
   auto ngo = nodeGraphicsObject(model()->nodeIndex(node.id()));
 
+  // not realized in a virtualized scene
+  if (!ngo)
+    return QSizeF();
+
   return QSizeF(ngo->geometry().width(), ngo->geometry().height());
   
 }
@@ -298,17 +477,25 @@ save() const
     QFileDialog::getSaveFileName(nullptr,
                                  tr("Open Flow Scene"),
                                  QDir::homePath(),
-                                 tr("Flow Scene Files (*.flow)"));
+                                 tr("Flow Scene Files (*.flow);;"
+                                    "Binary Flow Scene Files (*.flowb);;"
+                                    "Compressed Flow Scene Files (*.flowz)"));
 
   if (!fileName.isEmpty())
   {
-    if (!fileName.endsWith("flow", Qt::CaseInsensitive))
+    SceneFormat format = SceneFormat::Json;
+
+    if (fileName.endsWith(".flowb", Qt::CaseInsensitive))
+      format = SceneFormat::Binary;
+    else if (fileName.endsWith(".flowz", Qt::CaseInsensitive))
+      format = SceneFormat::Compressed;
+    else if (!fileName.endsWith("flow", Qt::CaseInsensitive))
       fileName += ".flow";
 
     QFile file(fileName);
     if (file.open(QIODevice::WriteOnly))
     {
-      file.write(saveToMemory());
+      file.write(saveToMemory(format));
     }
   }
 }
@@ -326,7 +513,7 @@ load()
     QFileDialog::getOpenFileName(nullptr,
                                  tr("Open Flow Scene"),
                                  QDir::homePath(),
-                                 tr("Flow Scene Files (*.flow)"));
+                                 tr("Flow Scene Files (*.flow *.flowb *.flowz)"));
 
   if (!QFileInfo::exists(fileName))
     return;
@@ -336,25 +523,68 @@ load()
   if (!file.open(QIODevice::ReadOnly))
     return;
 
-  QByteArray wholeFile = file.readAll();
+  // compressed scenes are inflated as a whole, at once
+  if (CompressedScene::isCompressed(file.peek(BinaryScene::HeaderSize)))
+  {
+    loadFromMemory(file.readAll());
+    return;
+  }
+
+  file.close();
 
-  loadFromMemory(wholeFile);
+  // the scene fills in from the event loop, which keeps running meanwhile
+  auto loader = new SceneLoader(*this, this);
+  connect(loader, &SceneLoader::finished, loader, &QObject::deleteLater);
+
+  if (!loader->start(fileName))
+  {
+    qWarning() << "Couldn't load" << fileName << ":" << loader->errorString();
+    delete loader;
+  }
 }
 
 
 QByteArray
 DataFlowScene::
-saveToMemory() const
+saveToMemory(SceneFormat format) const
+{
+  if (format == SceneFormat::Binary)
+  {
+    std::vector<Node const*> nodes;
+    nodes.reserve(_dataFlowModel->_nodes.size());
+
+    for (auto const& pair : _dataFlowModel->_nodes)
+      nodes.push_back(pair.second.get());
+
+    return saveToBinary(nodes);
+  }
+
+  if (format == SceneFormat::Compressed)
+    return CompressedScene::fromJson(saveToJson());
+
+  QJsonDocument document(saveToJson());
+
+  return document.toJson();
+}
+
+
+QJsonObject
+DataFlowScene::
+saveToJson() const
 {
   QJsonObject sceneJson;
 
   QJsonArray nodesJsonArray;
 
-  for (auto const & pair : _dataFlowModel->_nodes)
-  {
-    auto const &node = pair.second;
+  auto savedNodes = nodesToSave(_dataFlowModel->_nodes);
 
-    nodesJsonArray.append(node->save());
+  serializeNodes(savedNodes, [](SavedNode& item) {
+    item.json = item.node->save();
+  });
+
+  for (auto const & item : savedNodes)
+  {
+    nodesJsonArray.append(item.json);
   }
 
   sceneJson["nodes"] = nodesJsonArray;
@@ -372,9 +602,7 @@ saveToMemory() const
 
   sceneJson["connections"] = connectionJsonArray;
 
-  QJsonDocument document(sceneJson);
-
-  return document.toJson();
+  return sceneJson;
 }
 
 
@@ -382,21 +610,360 @@ void
 DataFlowScene::
 loadFromMemory(const QByteArray& data)
 {
-  QJsonObject const jsonDocument = QJsonDocument::fromJson(data).object();
+  if (BinaryScene::isBinary(data))
+  {
+    loadFromBinary(data);
+    return;
+  }
+
+  if (CompressedScene::isCompressed(data))
+  {
+    loadFromJson(CompressedScene::toJson(data));
+    return;
+  }
+
+  loadFromJson(QJsonDocument::fromJson(data).object());
+}
+
+
+void
+DataFlowScene::
+loadRegionFromMemory(const QByteArray& data, QRectF const& region)
+{
+  QJsonObject sceneJson;
+
+  // connections with one end outside of `region`
+  QJsonArray crossingJson;
+
+  if (CompressedScene::isCompressed(data))
+  {
+    CompressedSceneReader const reader(data);
+
+    if (!reader.isValid())
+      return;
+
+    sceneJson = reader.region(region, &crossingJson);
+  }
+  else
+  {
+    sceneJson = BinaryScene::isBinary(data)
+                ? BinaryScene::toJson(data)
+                : QJsonDocument::fromJson(data).object();
+
+    QJsonArray nodesJson;
+    QSet<QString> ids;
+
+    for (QJsonValue const& value : sceneJson["nodes"].toArray())
+    {
+      QJsonObject const node     = value.toObject();
+      QJsonObject const position = node["position"].toObject();
+
+      if (region.contains(QPointF(position["x"].toDouble(), position["y"].toDouble())))
+      {
+        ids.insert(node["id"].toString());
+        nodesJson.append(node);
+      }
+    }
+
+    QJsonArray connectionsJson;
+
+    for (QJsonValue const& value : sceneJson["connections"].toArray())
+    {
+      QJsonObject const connection = value.toObject();
+
+      bool const outInside = ids.contains(connection["out_id"].toString());
+      bool const inInside  = ids.contains(connection["in_id"].toString());
+
+      if (outInside && inInside)
+        connectionsJson.append(connection);
+      else if (outInside || inInside)
+        crossingJson.append(connection);
+    }
+
+    sceneJson["nodes"]       = nodesJson;
+    sceneJson["connections"] = connectionsJson;
+  }
+
+  // nodes loaded with an overlapping region before are not loaded again,
+  // their connections attach to the ones in the scene
+  QJsonArray newNodesJson;
+
+  for (QJsonValue const& value : sceneJson["nodes"].toArray())
+  {
+    if (!_dataFlowModel->nodeIndex(QUuid(value.toObject()["id"].toString())).isValid())
+      newNodesJson.append(value);
+  }
+
+  sceneJson["nodes"] = newNodesJson;
+
+  // connections leaving the region are made if their other end is in the
+  // scene already, and dropped otherwise
+  QJsonArray connectionsJson = sceneJson["connections"].toArray();
+
+  for (QJsonValue const& value : crossingJson)
+  {
+    QJsonObject const connection = value.toObject();
+
+    if (_dataFlowModel->nodeIndex(QUuid(connection["out_id"].toString())).isValid() ||
+        _dataFlowModel->nodeIndex(QUuid(connection["in_id"].toString())).isValid())
+      connectionsJson.append(connection);
+  }
+
+  sceneJson["connections"] = connectionsJson;
+
+  loadFromJson(sceneJson);
+}
+
+
+QString
+DataFlowScene::
+subgraphMimeType()
+{
+  return QStringLiteral("application/x-nodeeditor-subgraph");
+}
+
+
+QByteArray
+DataFlowScene::
+copySelection() const
+{
+  std::vector<Node*> const selected = selectedNodes();
+
+  return saveToBinary(std::vector<Node const*>(selected.begin(), selected.end()));
+}
+
+
+std::vector<Node*>
+DataFlowScene::
+paste(QByteArray const& data, QPointF const& offset)
+{
+  if (!BinaryScene::isBinary(data))
+    return {};
+
+  // the pasted items are evaluated, from their roots, and announced to the
+  // views once the bulk load inside ends
+  std::vector<QUuid> const ids = loadFromBinary(data, true, offset);
+
+  clearSelection();
+
+  std::vector<Node*> pasted;
+  pasted.reserve(ids.size());
+
+  for (QUuid const& id : ids)
+  {
+    pasted.push_back(_dataFlowModel->_nodes[id].get());
+
+    if (auto ngo = nodeGraphicsObject(id))
+      ngo->setSelected(true);
+  }
+
+  return pasted;
+}
+
+
+void
+DataFlowScene::
+copySelectionToClipboard() const
+{
+  auto mimeData = new QMimeData;
+  mimeData->setData(subgraphMimeType(), copySelection());
+
+  QApplication::clipboard()->setMimeData(mimeData);
+}
+
+
+std::vector<Node*>
+DataFlowScene::
+pasteFromClipboard(QPointF const& offset)
+{
+  QMimeData const* mimeData = QApplication::clipboard()->mimeData();
+
+  if (!mimeData || !mimeData->hasFormat(subgraphMimeType()))
+    return {};
+
+  return paste(mimeData->data(subgraphMimeType()), offset);
+}
+
+
+void
+DataFlowScene::
+loadFromJson(QJsonObject const& jsonDocument)
+{
+  // graphics are built and data propagated once, at the end
+  BulkLoad bulkLoad(*_dataFlowModel);
 
   QJsonArray nodesJsonArray = jsonDocument["nodes"].toArray();
 
+  std::vector<RestoredNode> nodes(nodesJsonArray.size());
+  std::vector<QString>      modelNames(nodesJsonArray.size());
+
   for (int i = 0; i < nodesJsonArray.size(); ++i)
   {
-    restoreNode(nodesJsonArray[i].toObject());
+    QJsonObject const nodeJson     = nodesJsonArray[i].toObject();
+    QJsonObject const positionJson = nodeJson["position"].toObject();
+
+    nodes[i].id        = QUuid(nodeJson["id"].toString());
+    nodes[i].position  = QPointF(positionJson["x"].toDouble(), positionJson["y"].toDouble());
+    nodes[i].modelJson = nodeJson["model"].toObject();
+    modelNames[i]      = nodes[i].modelJson.value("name").toString();
   }
 
+  // ids already in the scene are replaced by fresh ones
+  std::unordered_map<QUuid, QUuid> idMap;
+
+  restoreNodes(*_dataFlowModel, nodes, modelNames,
+               [](RestoredNode const& item) { return item.modelJson; },
+               idMap);
+
   QJsonArray connectionJsonArray = jsonDocument["connections"].toArray();
 
   for (int i = 0; i < connectionJsonArray.size(); ++i)
   {
-    restoreConnection(connectionJsonArray[i].toObject());
+    QJsonObject connectionJson = connectionJsonArray[i].toObject();
+
+    for (QString const key : {QStringLiteral("out_id"), QStringLiteral("in_id")})
+    {
+      auto iter = idMap.find(QUuid(connectionJson[key].toString()));
+
+      if (iter != idMap.end())
+        connectionJson[key] = iter->second.toString();
+    }
+
+    restoreConnection(connectionJson);
+  }
+}
+
+
+QByteArray
+DataFlowScene::
+saveToBinary(std::vector<Node const*> const& nodes) const
+{
+  bool const wholeScene = nodes.size() == _dataFlowModel->_nodes.size();
+
+  BinarySceneWriter writer(nodes.size(),
+                           wholeScene ? _dataFlowModel->_connections.size() : 0);
+
+  auto savedNodes = nodesToSave(nodes);
+
+  // the blob encoding is per node too
+  serializeNodes(savedNodes, [](SavedNode& item) {
+    item.blob = BinarySceneWriter::encodeState(item.node->nodeDataModel()->save(), item.modelName);
+  });
+
+  for (auto const & item : savedNodes)
+  {
+    writer.addNode(item.node->id(), item.node->position(), item.modelName, item.blob);
+  }
+
+  QSet<QUuid> saved;
+
+  if (!wholeScene)
+  {
+    saved.reserve(int(nodes.size()));
+
+    for (Node const* node : nodes)
+      saved.insert(node->id());
+  }
+
+  for (auto const & pair : _dataFlowModel->_connections)
+  {
+    auto const &id = pair.first;
+
+    if (wholeScene || (saved.contains(id.lNodeID) && saved.contains(id.rNodeID)))
+    {
+      writer.addConnection(id.lNodeID, id.lPortID, id.rNodeID, id.rPortID);
+    }
+  }
+
+  return writer.finish();
+}
+
+
+std::vector<QUuid>
+DataFlowScene::
+loadFromBinary(const QByteArray& data, bool freshIds, QPointF const& offset)
+{
+  BinarySceneReader reader(data);
+
+  std::vector<BinarySceneReader::ConnectionEntry> connections;
+
+  if (!reader.isValid() || !reader.connections(connections))
+    return {};
+
+  _dataFlowModel->reserve(_dataFlowModel->_nodes.size() + reader.nodeCount(),
+                          _dataFlowModel->_connections.size() + connections.size());
+
+  BulkLoad bulkLoad(*_dataFlowModel);
+
+  std::vector<RestoredNode> nodes(reader.nodeCount());
+  std::vector<QString>      modelNames(reader.nodeCount());
+  std::vector<BinarySceneReader::NodeEntry> entries(reader.nodeCount());
+
+  // new ids for the ones in `data`: all of them with `freshIds`, otherwise
+  // those already in the scene
+  std::unordered_map<QUuid, QUuid> idMap;
+
+  if (freshIds)
+    idMap.reserve(reader.nodeCount());
+
+  for (std::size_t i = 0; i < reader.nodeCount(); ++i)
+  {
+    entries[i] = reader.node(i);
+
+    if (freshIds)
+    {
+      nodes[i].id = QUuid::createUuid();
+      idMap[entries[i].id] = nodes[i].id;
+    }
+    else
+    {
+      nodes[i].id = entries[i].id;
+    }
+
+    nodes[i].position = entries[i].position + offset;
+    nodes[i].entry    = i;
+    modelNames[i]     = entries[i].modelName;
+  }
+
+  // the blobs are parsed on the worker threads as well
+  restoreNodes(*_dataFlowModel, nodes, modelNames,
+               [&](RestoredNode const& item) { return reader.modelState(entries[item.entry]); },
+               idMap);
+
+  for (auto const& connection : connections)
+  {
+    QUuid outID = connection.outNode;
+    QUuid inID  = connection.inNode;
+
+    auto outIter = idMap.find(outID);
+    auto inIter  = idMap.find(inID);
+
+    // with `freshIds` connections to nodes outside `data` are dropped
+    if (freshIds && (outIter == idMap.end() || inIter == idMap.end()))
+      continue;
+
+    if (outIter != idMap.end())
+      outID = outIter->second;
+
+    if (inIter != idMap.end())
+      inID = inIter->second;
+
+    auto outNode = _dataFlowModel->nodeIndex(outID);
+    auto inNode  = _dataFlowModel->nodeIndex(inID);
+
+    if (outNode.isValid() && inNode.isValid())
+    {
+      _dataFlowModel->addConnection(outNode, connection.outPort, inNode, connection.inPort);
+    }
   }
+
+  std::vector<QUuid> ids;
+  ids.reserve(nodes.size());
+
+  for (auto const& item : nodes)
+    ids.push_back(item.id);
+
+  return ids;
 }
 
 } // namespace QtNodes
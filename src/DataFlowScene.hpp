@@ -19,6 +19,13 @@ class Connection;
 class DataModelRegistry;
 class NodeDataModel;
 
+enum class SceneFormat
+{
+  Json,
+  Binary,    ///< see BinaryScene
+  Compressed ///< see CompressedScene
+};
+
 class NODE_EDITOR_PUBLIC DataFlowScene : public FlowScene {
   Q_OBJECT
 
@@ -40,6 +47,13 @@ public:
 
   Node& restoreNode(QJsonObject const& nodeJson);
 
+  /// Creates the model by name, restores its state and adds it under `id`.
+  /// Throws std::logic_error if the name is unknown or `id` is in use.
+  Node& restoreNode(QUuid const& id,
+                    QString const& modelName,
+                    QPointF const& position,
+                    QJsonObject const& modelJson);
+
   void removeNode(Node& node);
 
   DataModelRegistry& registry() const;
@@ -56,6 +70,7 @@ public:
 
   void setNodePosition(Node& node, const QPointF& pos) const;
 
+  /// Empty if the node has no graphics, see `FlowScene::setVirtualized`
   QSizeF getNodeSize(const Node& node) const;
 public:
 
@@ -71,14 +86,48 @@ public:
 
   void save() const;
 
+  /// Asks for a file and loads it into the emptied scene. The scene fills
+  /// in from the event loop through a SceneLoader; compressed scenes are
+  /// loaded at once.
   void load();
 
-  QByteArray saveToMemory() const;
+  QByteArray saveToMemory(SceneFormat format = SceneFormat::Json) const;
 
+  /// Accepts any format. Adds to what the scene contains; nodes whose id
+  /// is already in use are loaded under a fresh one.
   void loadFromMemory(const QByteArray& data);
 
+  /// Loads only the nodes positioned in `region` and the connections
+  /// between them. Compressed scenes inflate just the chunks overlapping
+  /// `region`; the other formats are read whole and filtered. Nodes already
+  /// in the scene, e.g. from an overlapping region, are not loaded again.
+  /// Connections leaving `region` are made to nodes the scene has already,
+  /// so loading neighbouring regions one after the other joins them up;
+  /// those to nodes it doesn't have are dropped.
+  void loadRegionFromMemory(const QByteArray& data, QRectF const& region);
+
+public:
+
+  /// MIME type of `copySelection()` data on the clipboard
+  static QString subgraphMimeType();
+
+  /// The selected nodes and the connections between them, in the binary
+  /// scene format
+  QByteArray copySelection() const;
+
+  /// Adds the nodes and connections of `data` under new ids, moved by
+  /// `offset`, and makes them the selection. Returns the new nodes.
+  std::vector<Node*> paste(QByteArray const& data, QPointF const& offset = QPointF());
+
+  void copySelectionToClipboard() const;
+
+  /// Does nothing if the clipboard holds no subgraph
+  std::vector<Node*> pasteFromClipboard(QPointF const& offset = QPointF());
+
 signals:
 
+  /// Nodes and connections from loads and pastes are announced once the
+  /// whole batch is in the model, evaluated
   void nodeCreated(Node &n);
 
   void nodeDeleted(Node &n);
@@ -98,6 +147,21 @@ signals:
 
   void nodeHoverLeft(Node& n);
   
+private:
+
+  QJsonObject saveToJson() const;
+
+  void loadFromJson(QJsonObject const& sceneJson);
+
+  /// Saves `nodes` and the connections between them
+  QByteArray saveToBinary(std::vector<Node const*> const& nodes) const;
+
+  /// With `freshIds` the nodes are added under new ids and connections to
+  /// nodes outside `data` are dropped. Returns the ids of the nodes added.
+  std::vector<QUuid> loadFromBinary(const QByteArray& data,
+                                    bool freshIds = false,
+                                    QPointF const& offset = QPointF());
+
 private:
   
   DataFlowModel* _dataFlowModel;
@@ -1,31 +1,285 @@
 #include "DataModelRegistry.hpp"
 
+#include <deque>
+
 #include <QtCore/QFile>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QLibrary>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QDebug>
 #include <QtWidgets/QMessageBox>
 
+#include "NodeDataModelPlugin.hpp"
+
 using QtNodes::DataModelRegistry;
 using QtNodes::NodeDataModel;
+using QtNodes::NodeDataModelPlugin;
+using QtNodes::NodeDataType;
+
+namespace
+{
+
+/// A library found by `loadPlugins`. It is loaded on the first `create`,
+/// registering its models into a registry of its own.
+class PluginLibrary
+{
+public:
+
+  explicit
+  PluginLibrary(QString const &fileName)
+    : _loader(fileName)
+  {}
+
+  QJsonObject
+  metaData() const
+  {
+    return _loader.metaData();
+  }
+
+  std::unique_ptr<NodeDataModel>
+  create(QString const &modelName)
+  {
+    if (!_registry)
+    {
+      load();
+    }
+
+    return _registry->create(modelName);
+  }
+
+private:
+
+  void
+  load()
+  {
+    _registry = std::make_unique<DataModelRegistry>();
+
+    auto plugin = qobject_cast<NodeDataModelPlugin*>(_loader.instance());
+
+    if (!plugin)
+    {
+      qWarning() << "Couldn't load plugin" << _loader.fileName()
+                 << _loader.errorString();
+      return;
+    }
+
+    plugin->registerDataModels(*_registry);
+  }
+
+private:
+
+  QPluginLoader _loader;
+
+  std::unique_ptr<DataModelRegistry> _registry;
+};
+
+NodeDataType
+dataTypeFromJson(QJsonObject const &json)
+{
+  return NodeDataType{json["id"].toString(), json["name"].toString()};
+}
+
+}
+
+
+std::size_t
+DataModelRegistry::
+loadPlugins(QString const &directory)
+{
+  std::size_t registered = 0;
+
+  for (QFileInfo const &fileInfo : QDir(directory).entryInfoList(QDir::Files))
+  {
+    if (!QLibrary::isLibrary(fileInfo.fileName()))
+      continue;
+
+    auto library = std::make_shared<PluginLibrary>(fileInfo.absoluteFilePath());
+
+    // read from the file, the library itself stays unloaded
+    QJsonObject const metaData = library->metaData();
+
+    if (metaData["IID"].toString() != QLatin1String(NodeDataModelPlugin_iid))
+      continue;
+
+    QJsonArray const models = metaData["MetaData"].toObject()["models"].toArray();
+
+    for (QJsonValue const &value : models)
+    {
+      QJsonObject const modelJson = value.toObject();
+
+      QString const name = modelJson["name"].toString();
+
+      if (name.isEmpty() || _registeredItemCreators.count(name) != 0)
+        continue;
+
+      QString const category = modelJson["category"].toString("Nodes");
+
+      RegistryItemCreator creator = [library, name](){ return library->create(name); };
+
+      _registeredItemCreators[name] = creator;
+      _categories.insert(category);
+      _registeredModelsCategory[name] = category;
+      ++_generation;
+
+      ++registered;
+
+      if (!modelJson.contains("converter"))
+        continue;
+
+      QJsonObject const converterJson = modelJson["converter"].toObject();
+
+      TypeConverterItemPtr converter = std::make_unique<TypeConverterItem>();
+      converter->ModelName = name;
+      converter->Creator = std::move(creator);
+      converter->SourceType = dataTypeFromJson(converterJson["from"].toObject());
+      converter->DestinationType = dataTypeFromJson(converterJson["to"].toObject());
+
+      if (converter->SourceType.id.isEmpty() ||
+          converter->SourceType.id == converter->DestinationType.id)
+        continue;
+
+      auto typeConverterKey = std::make_pair(converter->SourceType.id, converter->DestinationType.id);
+      _registeredTypeConverters[typeConverterKey] = std::move(converter);
+
+      _converterRoutesValid = false;
+    }
+  }
+
+  return registered;
+}
+
 
 std::unique_ptr<NodeDataModel>
 DataModelRegistry::
 create(QString const &modelName)
 {
-  auto it = _registeredModels.find(modelName);
+  auto pool = _modelPools.find(modelName);
 
-  if (it != _registeredModels.end())
+  if (pool != _modelPools.end() && !pool->second.instances.empty())
   {
-    return it->second->clone();
+    RegistryItemPtr model = std::move(pool->second.instances.back());
+    pool->second.instances.pop_back();
+
+    return model;
   }
 
-  return nullptr;
+  auto it = _registeredItemCreators.find(modelName);
+
+  if (it == _registeredItemCreators.end())
+  {
+    return nullptr;
+  }
+
+  RegistryItemPtr model = it->second();
+
+  if (model && _uncheckedNames.erase(modelName) != 0 && model->name() != modelName)
+  {
+    qWarning() << "Model" << model->name() << "is registered as" << modelName
+               << "- is its static Name() inherited from a base model?";
+  }
+
+  return model;
+}
+
+
+void
+DataModelRegistry::
+setPoolCapacity(QString const &modelName, std::size_t capacity)
+{
+  if (capacity == 0)
+  {
+    _modelPools.erase(modelName);
+    return;
+  }
+
+  ModelPool &pool = _modelPools[modelName];
+
+  pool.capacity = capacity;
+
+  if (pool.instances.size() > capacity)
+  {
+    pool.instances.resize(capacity);
+  }
+}
+
+
+bool
+DataModelRegistry::
+recyclable(QString const &modelName) const
+{
+  return _modelPools.count(modelName) != 0;
+}
+
+
+void
+DataModelRegistry::
+recycle(std::unique_ptr<NodeDataModel> model)
+{
+  auto pool = _modelPools.find(model->name());
+
+  if (pool == _modelPools.end() ||
+      pool->second.instances.size() >= pool->second.capacity)
+    return;
+
+  if (!model->resetState())
+    return;
+
+  pool->second.instances.push_back(std::move(model));
+}
+
+
+void
+DataModelRegistry::
+registerDataSerializer(QString const &typeID,
+                       NodeDataSerializer serializer,
+                       NodeDataDeserializer deserializer)
+{
+  _dataSerializers[typeID] = DataSerializer{std::move(serializer), std::move(deserializer)};
+}
+
+
+bool
+DataModelRegistry::
+dataSerializable(QString const &typeID) const
+{
+  return _dataSerializers.count(typeID) != 0;
+}
+
+
+QByteArray
+DataModelRegistry::
+serializeData(NodeData const &data) const
+{
+  auto iter = _dataSerializers.find(data.type().id);
+
+  if (iter == _dataSerializers.end())
+    return QByteArray();
+
+  return iter->second.serialize(data);
+}
+
+
+std::shared_ptr<NodeData>
+DataModelRegistry::
+deserializeData(QString const &typeID, QByteArray const &bytes) const
+{
+  auto iter = _dataSerializers.find(typeID);
+
+  if (iter == _dataSerializers.end())
+    return nullptr;
+
+  return iter->second.deserialize(bytes);
 }
 
 
-DataModelRegistry::RegisteredModelsMap const &
+DataModelRegistry::RegisteredModelCreatorsMap const &
 DataModelRegistry::
-registeredModels() const
+registeredModelCreators() const
 {
-  return _registeredModels;
+  return _registeredItemCreators;
 }
 
 
@@ -54,7 +308,171 @@ getTypeConverter(QString const &sourceTypeID, QString const &destTypeID) const
 
   if (converter != _registeredTypeConverters.end())
   {
-    return converter->second->Model->clone();
+    return converter->second->Creator();
   }
   return nullptr;
-}
\ No newline at end of file
+}
+
+
+void
+DataModelRegistry::
+registerTypeConverter(QString const &name)
+{
+  RegistryItemCreator const &creator = _registeredItemCreators.at(name);
+
+  RegistryItemPtr model = creator();
+
+  //Type converter node should have exactly one input and output ports, if thats not the case, we skip the registration.
+  //If the input and output type is the same, we also skip registration, because thats not a typecast node.
+  if (model->nPorts(PortType::In) != 1 || model->nPorts(PortType::Out) != 1 ||
+    model->dataType(PortType::In, 0).id == model->dataType(PortType::Out, 0).id)
+  {
+    return;
+  }
+
+  TypeConverterItemPtr converter = std::make_unique<TypeConverterItem>();
+  converter->ModelName = name;
+  converter->Creator = creator;
+  converter->SourceType = model->dataType(PortType::In, 0);
+  converter->DestinationType = model->dataType(PortType::Out, 0);
+
+  auto typeConverterKey = std::make_pair(converter->SourceType.id, converter->DestinationType.id);
+  _registeredTypeConverters[typeConverterKey] = std::move(converter);
+}
+
+
+QString
+DataModelRegistry::
+getTypeConverterName(QString const &sourceTypeID, QString const &destTypeID) const
+{
+  auto typeConverterKey = std::make_pair(sourceTypeID, destTypeID);
+  auto converter = _registeredTypeConverters.find(typeConverterKey);
+
+  if (converter != _registeredTypeConverters.end())
+  {
+    return converter->second->ModelName;
+  }
+  return QString();
+}
+
+
+QStringList
+DataModelRegistry::
+getTypeConverterChain(QString const &sourceTypeID, QString const &destTypeID) const
+{
+  QStringList chain;
+
+  int       current = internedTypeId(sourceTypeID);
+  int const dest    = internedTypeId(destTypeID);
+
+  if (current < 0 || dest < 0 || current == dest ||
+      !route(current, dest).firstConverter)
+    return chain;
+
+  // every first hop lies on a shortest chain, so following them from any
+  // type on the way reaches the destination in the fewest steps
+  while (current != dest)
+  {
+    ConverterRoute const &hop = route(current, dest);
+
+    chain.append(hop.firstConverter->ModelName);
+    current = hop.nextType;
+  }
+
+  return chain;
+}
+
+
+bool
+DataModelRegistry::
+typesConvertible(QString const &sourceTypeID, QString const &destTypeID) const
+{
+  int const source = internedTypeId(sourceTypeID);
+  int const dest   = internedTypeId(destTypeID);
+
+  return source >= 0 && dest >= 0 && source != dest &&
+         route(source, dest).firstConverter != nullptr;
+}
+
+
+int
+DataModelRegistry::
+internedTypeId(QString const &typeID) const
+{
+  if (!_converterRoutesValid)
+    buildConverterRoutes();
+
+  auto iter = _converterTypeIds.find(typeID);
+
+  return iter == _converterTypeIds.end() ? -1 : iter->second;
+}
+
+
+DataModelRegistry::ConverterRoute const&
+DataModelRegistry::
+route(int sourceType, int destType) const
+{
+  return _converterRoutes[sourceType * _converterTypeIds.size() + destType];
+}
+
+
+void
+DataModelRegistry::
+buildConverterRoutes() const
+{
+  _converterTypeIds.clear();
+
+  auto intern = [this](QString const &typeID) {
+    return _converterTypeIds.emplace(typeID, int(_converterTypeIds.size())).first->second;
+  };
+
+  // adjacency by source type
+  std::vector<std::vector<std::pair<TypeConverterItem const*, int>>> outgoing;
+  for (auto const &entry : _registeredTypeConverters)
+  {
+    int const source = intern(entry.first.first);
+    int const dest   = intern(entry.first.second);
+
+    outgoing.resize(_converterTypeIds.size());
+    outgoing[source].emplace_back(entry.second.get(), dest);
+  }
+
+  std::size_t const typeCount = _converterTypeIds.size();
+
+  _converterRoutes.assign(typeCount * typeCount, ConverterRoute());
+
+  std::deque<int> queue;
+
+  for (std::size_t start = 0; start < typeCount; ++start)
+  {
+    ConverterRoute* row = &_converterRoutes[start * typeCount];
+
+    auto visit = [&](ConverterRoute const &firstHop, int reached) {
+      if (std::size_t(reached) != start && !row[reached].firstConverter)
+      {
+        row[reached] = firstHop;
+        queue.push_back(reached);
+      }
+    };
+
+    for (auto const &edge : outgoing[start])
+    {
+      visit(ConverterRoute{edge.first, edge.second}, edge.second);
+    }
+
+    while (!queue.empty())
+    {
+      int const type = queue.front();
+      queue.pop_front();
+
+      ConverterRoute const firstHop = row[type];
+
+      for (auto const &edge : outgoing[type])
+      {
+        visit(firstHop, edge.second);
+      }
+    }
+  }
+
+  _converterRoutesValid = true;
+}
@@ -1,10 +1,16 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
 #include <set>
+#include <vector>
 #include <memory>
+#include <functional>
+#include <type_traits>
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
 #include "NodeDataModel.hpp"
 #include "Export.hpp"
@@ -13,22 +19,34 @@
 namespace QtNodes
 {
 
-/// Class uses map for storing models (name, model)
+/// Class uses map for storing model factories (name, creator).
+///
+/// Models are only instantiated by `create`. Registering a model whose
+/// class has a `static QString Name()` builds no instance at all; without
+/// it, or for type converters whose port types are needed, a temporary
+/// instance is created once and discarded. `Name()` must return what
+/// `name()` does; a `Name()` inherited from a base model would register the
+/// model under the base's name, which the first `create` of it reports.
 class NODE_EDITOR_PUBLIC DataModelRegistry
 {
 
 public:
 
   using RegistryItemPtr             = std::unique_ptr<NodeDataModel>;
-  using RegisteredModelsMap         = std::unordered_map<QString, RegistryItemPtr>;
+  using RegistryItemCreator         = std::function<RegistryItemPtr()>;
+  using RegisteredModelCreatorsMap  = std::unordered_map<QString, RegistryItemCreator>;
   using RegisteredModelsCategoryMap = std::unordered_map<QString, QString>;
   using CategoriesSet               = std::set<QString>;
 
+  using NodeDataSerializer   = std::function<QByteArray(NodeData const &)>;
+  using NodeDataDeserializer = std::function<std::shared_ptr<NodeData>(QByteArray const &)>;
+
   struct TypeConverterItem
   {
-    RegistryItemPtr Model{};
-    NodeDataType    SourceType{};
-    NodeDataType    DestinationType{};
+    QString             ModelName{};
+    RegistryItemCreator Creator{};
+    NodeDataType        SourceType{};
+    NodeDataType        DestinationType{};
   };
 
   using ConvertingTypesPair = std::pair<QString, QString>; //Source type ID, Destination type ID in this order
@@ -50,55 +68,112 @@ public:
 
   template<typename ModelType, bool TypeConverter = false>
   void
-  registerModel(std::unique_ptr<ModelType> uniqueModel = std::make_unique<ModelType>(), QString const &category = "Nodes")
+  registerModel(RegistryItemCreator creator, QString const &category = "Nodes")
   {
     static_assert(std::is_base_of<NodeDataModel, ModelType>::value,
                   "Must pass a subclass of NodeDataModel to registerModel");
 
-    QString const name = uniqueModel->name();
+    QString const name = computeName<ModelType>(HasStaticMethodName<ModelType>{}, creator);
+
+    // new models may add converters, routes are rebuilt on the next query
+    _converterRoutesValid = false;
 
-    if (_registeredModels.count(name) == 0)
+    if (_registeredItemCreators.count(name) == 0)
     {
-      _registeredModels[name] = std::move(uniqueModel);
+      _registeredItemCreators[name] = std::move(creator);
       _categories.insert(category);
       _registeredModelsCategory[name] = category;
+      ++_generation;
+
+      // checked against name() once an instance exists
+      if (HasStaticMethodName<ModelType>::value)
+        _uncheckedNames.insert(name);
     }
 
     if (TypeConverter)
     {
-      std::unique_ptr<NodeDataModel>& registeredModelRef = _registeredModels[name];
-
-      //Type converter node should have exactly one input and output ports, if thats not the case, we skip the registration.
-      //If the input and output type is the same, we also skip registration, because thats not a typecast node.
-      if (registeredModelRef->nPorts(PortType::In) != 1 || registeredModelRef->nPorts(PortType::Out) != 1 ||
-        registeredModelRef->dataType(PortType::In, 0).id == registeredModelRef->dataType(PortType::Out, 0).id)
-      {
-        return;
-      }
-
-      TypeConverterItemPtr converter = std::make_unique<TypeConverterItem>();
-      converter->Model = registeredModelRef->clone();
-      converter->SourceType = converter->Model->dataType(PortType::In, 0);
-      converter->DestinationType = converter->Model->dataType(PortType::Out, 0);
-
-      auto typeConverterKey = std::make_pair(converter->SourceType.id, converter->DestinationType.id);
-	  _registeredTypeConverters[typeConverterKey] = std::move(converter);
+      registerTypeConverter(name);
     }
   }
 
-  //Parameter order alias, so a category can be set without forcing to manually pass a model instance
   template<typename ModelType, bool TypeConverter = false>
   void
-  registerModel(QString const &category, std::unique_ptr<ModelType> uniqueModel = std::make_unique<ModelType>())
+  registerModel(QString const &category = "Nodes")
+  {
+    RegistryItemCreator creator = [](){ return std::make_unique<ModelType>(); };
+    registerModel<ModelType, TypeConverter>(std::move(creator), category);
+  }
+
+  /// Registration from a prototype, kept for compatibility: `create`
+  /// clones the prototype, which stays alive as long as the registry
+  template<typename ModelType, bool TypeConverter = false>
+  void
+  registerModel(std::unique_ptr<ModelType> uniqueModel, QString const &category = "Nodes")
+  {
+    std::shared_ptr<ModelType> prototype = std::move(uniqueModel);
+
+    RegistryItemCreator creator = [prototype](){ return prototype->clone(); };
+    registerModel<ModelType, TypeConverter>(std::move(creator), category);
+  }
+
+  //Parameter order alias, so a category can be set together with a prototype
+  template<typename ModelType, bool TypeConverter = false>
+  void
+  registerModel(QString const &category, std::unique_ptr<ModelType> uniqueModel)
   {
     registerModel<ModelType, TypeConverter>(std::move(uniqueModel), category);
   }
 
+  /// Scans `directory` for libraries implementing NodeDataModelPlugin and
+  /// registers the models listed in their metadata. Only the metadata is
+  /// read here; a library is loaded when one of its models is first
+  /// created. Returns the number of models registered.
+  std::size_t
+  loadPlugins(QString const &directory);
+
+  /// Changes whenever a model is registered, for caches of the model list
+  std::size_t
+  generation() const { return _generation; }
+
+  /// Returns a pooled instance if one is available, otherwise a new one
   std::unique_ptr<NodeDataModel>
   create(QString const &modelName);
 
-  RegisteredModelsMap const &
-  registeredModels() const;
+  /// Keeps up to `capacity` instances of `modelName` handed back through
+  /// `recycle` for reuse by `create`. A capacity of 0, the default,
+  /// disables pooling for the model. See `NodeDataModel::resetState`.
+  void
+  setPoolCapacity(QString const &modelName, std::size_t capacity);
+
+  /// Whether instances of `modelName` are pooled
+  bool
+  recyclable(QString const &modelName) const;
+
+  /// Resets the model and keeps it for `create` if its type is pooled and
+  /// the pool has room, destroys it otherwise
+  void
+  recycle(std::unique_ptr<NodeDataModel> model);
+
+  /// Makes NodeData of type `typeID` serializable, which lets
+  /// NodeOutputCache persist it
+  void
+  registerDataSerializer(QString const &typeID,
+                         NodeDataSerializer serializer,
+                         NodeDataDeserializer deserializer);
+
+  bool
+  dataSerializable(QString const &typeID) const;
+
+  /// Empty if the type of `data` has no serializer
+  QByteArray
+  serializeData(NodeData const &data) const;
+
+  /// nullptr if `typeID` has no deserializer or it fails
+  std::shared_ptr<NodeData>
+  deserializeData(QString const &typeID, QByteArray const &bytes) const;
+
+  RegisteredModelCreatorsMap const &
+  registeredModelCreators() const;
   
   RegisteredModelsCategoryMap const &
   registeredModelsCategoryAssociation() const;
@@ -110,11 +185,107 @@ public:
   getTypeConverter(QString const &sourceTypeID,
                    QString const &destTypeID) const;
 
+  /// Name of the model converting `sourceTypeID` directly into
+  /// `destTypeID`, or an empty string. Does not create the model.
+  QString
+  getTypeConverterName(QString const &sourceTypeID,
+                       QString const &destTypeID) const;
+
+  /// Names of the converter models that turn `sourceTypeID` into
+  /// `destTypeID` when chained in order, using as few converters as
+  /// possible. Empty if the types are equal or cannot be converted.
+  QStringList
+  getTypeConverterChain(QString const &sourceTypeID,
+                        QString const &destTypeID) const;
+
+  /// Whether some chain of converters turns `sourceTypeID` into
+  /// `destTypeID`: two hash lookups and a table read, no allocation
+  bool
+  typesConvertible(QString const &sourceTypeID,
+                   QString const &destTypeID) const;
+
+private:
+
+  template <typename T, typename = void>
+  struct HasStaticMethodName
+    : std::false_type
+  {};
+
+  template <typename T>
+  struct HasStaticMethodName<T,
+      typename std::enable_if<std::is_same<decltype(T::Name()), QString>::value>::type>
+    : std::true_type
+  {};
+
+  template <typename ModelType>
+  static QString
+  computeName(std::true_type, RegistryItemCreator const&)
+  {
+    return ModelType::Name();
+  }
+
+  template <typename ModelType>
+  static QString
+  computeName(std::false_type, RegistryItemCreator const& creator)
+  {
+    return creator()->name();
+  }
+
+  /// Instantiates the model once to read its port types. A converter has
+  /// exactly one input and one output of different types, anything else is
+  /// skipped.
+  void
+  registerTypeConverter(QString const &name);
+
+  /// Interns the data types used by converters and fills the routing
+  /// matrix with a breadth-first search from every source type
+  void
+  buildConverterRoutes() const;
+
+  /// Matrix entry for the shortest chain from one type to another
+  struct ConverterRoute
+  {
+    TypeConverterItem const* firstConverter = nullptr;
+    int                      nextType       = -1;
+  };
+
+  int
+  internedTypeId(QString const &typeID) const;
+
+  ConverterRoute const&
+  route(int sourceType, int destType) const;
+
 private:
 
   RegisteredModelsCategoryMap _registeredModelsCategory{};
   CategoriesSet _categories{};
-  RegisteredModelsMap _registeredModels{};
+  RegisteredModelCreatorsMap _registeredItemCreators{};
+  std::size_t _generation = 0;
+
+  // registered by a static Name() that no instance has confirmed yet
+  std::unordered_set<QString> _uncheckedNames{};
+
+  struct ModelPool
+  {
+    std::size_t                  capacity = 0;
+    std::vector<RegistryItemPtr> instances{};
+  };
+
+  std::unordered_map<QString, ModelPool> _modelPools{};
+
+  struct DataSerializer
+  {
+    NodeDataSerializer   serialize;
+    NodeDataDeserializer deserialize;
+  };
+
+  std::unordered_map<QString, DataSerializer> _dataSerializers{};
   RegisteredTypeConvertersMap _registeredTypeConverters{};
+
+  // dense ids for the data type ids converters accept or produce,
+  // and a row-major (source, destination) matrix of first hops
+  mutable std::unordered_map<QString, int> _converterTypeIds{};
+  mutable std::vector<ConverterRoute>      _converterRoutes{};
+  mutable bool                             _converterRoutesValid = false;
 };
 }
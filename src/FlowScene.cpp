@@ -3,8 +3,38 @@
 #include "ConnectionGraphicsObject.hpp"
 #include "NodeGraphicsObject.hpp"
 
+#include <cmath>
+#include <memory>
+#include <algorithm>
+#include <unordered_set>
+
+#include <QtWidgets/QGraphicsView>
+#include <QtWidgets/QWidget>
+
 namespace QtNodes {
 
+namespace
+{
+
+// side of the grid cells indexing node positions, in scene units
+constexpr double CellSize = 512.0;
+
+std::uint64_t
+cellKey(int x, int y)
+{
+  return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y);
+}
+
+
+std::uint64_t
+cellKey(QPointF const& position)
+{
+  return cellKey(int(std::floor(position.x() / CellSize)),
+                 int(std::floor(position.y() / CellSize)));
+}
+
+}
+
 FlowScene::FlowScene(FlowSceneModel* model) 
   : _model(model)
 {
@@ -12,11 +42,13 @@ FlowScene::FlowScene(FlowSceneModel* model)
 
   connect(model, &FlowSceneModel::nodeRemoved, this, &FlowScene::nodeRemoved);
   connect(model, &FlowSceneModel::nodeAdded, this, &FlowScene::nodeAdded);
+  connect(model, &FlowSceneModel::nodeAboutToBeRemoved, this, &FlowScene::nodeAboutToBeRemoved);
   connect(model, &FlowSceneModel::nodePortUpdated, this, &FlowScene::nodePortUpdated);
   connect(model, &FlowSceneModel::nodeValidationUpdated, this, &FlowScene::nodeValidationUpdated);
   connect(model, &FlowSceneModel::connectionRemoved, this, &FlowScene::connectionRemoved);
   connect(model, &FlowSceneModel::connectionAdded, this, &FlowScene::connectionAdded);
   connect(model, &FlowSceneModel::nodeMoved, this, &FlowScene::nodeMoved);
+  connect(model, &FlowSceneModel::modelReset, this, &FlowScene::modelReset);
 
   /* expose focus changes within the scene to scenemodel */
   auto onFocusChange = [this] (QGraphicsItem *item) {
@@ -31,6 +63,37 @@ FlowScene::FlowScene(FlowSceneModel* model)
   };
   connect(this, &QGraphicsScene::focusItemChanged, this, onFocusChange);
 
+  buildGraphics();
+}
+
+FlowScene::~FlowScene()
+{
+  clearGraphics();
+
+  for (auto const& pair : _nodeWidgets) {
+    delete pair.second;
+  }
+}
+
+void
+FlowScene::
+buildGraphics()
+{
+  auto model = this->model();
+
+  if (_virtualized) {
+    _grid.clear();
+    _nodeCells.clear();
+    _realizedRegion = QRectF();
+
+    for (const auto& n : model->nodeUUids()) {
+      indexNode(n, model->nodeLocation(model->nodeIndex(n)));
+    }
+
+    updateVisibleRegion();
+    return;
+  }
+
   // emit node added on all the existing nodes
   for (const auto& n : model->nodeUUids()) {
     nodeAdded(n);
@@ -59,7 +122,21 @@ FlowScene::FlowScene(FlowSceneModel* model)
   }
 }
 
-FlowScene::~FlowScene() = default;
+void
+FlowScene::
+clearGraphics()
+{
+  // connections first, nodes refer to them
+  for (auto const& pair : _connGraphicsObjects) {
+    delete pair.second;
+  }
+  _connGraphicsObjects.clear();
+
+  for (auto const& pair : _nodeGraphicsObjects) {
+    delete pair.second;
+  }
+  _nodeGraphicsObjects.clear();
+}
 
 NodeGraphicsObject*
 FlowScene::
@@ -94,12 +171,339 @@ selectedNodes() const {
 
 }
 
+void
+FlowScene::
+setVirtualized(bool virtualized)
+{
+  if (virtualized == _virtualized) {
+    return;
+  }
+
+  clearGraphics();
+
+  _virtualized = virtualized;
+
+  if (!virtualized) {
+    _grid.clear();
+    _nodeCells.clear();
+    _realizedRegion = QRectF();
+  }
+
+  buildGraphics();
+}
+
+void
+FlowScene::
+updateVisibleRegion()
+{
+  if (!_virtualized) {
+    return;
+  }
+
+  QRectF const visible = visibleRegion();
+  if (visible.isEmpty()) {
+    return;
+  }
+
+  // realize half a screen around the views, release beyond a full screen
+  qreal const dx = visible.width() / 2.0;
+  qreal const dy = visible.height() / 2.0;
+
+  QRectF const wanted = visible.adjusted(-dx, -dy, dx, dy);
+  QRectF const kept   = wanted.adjusted(-dx, -dy, dx, dy);
+
+  std::vector<QUuid> const inRegion = indexedNodesIn(wanted);
+
+  std::unordered_set<QUuid> wantedNodes(inRegion.begin(), inRegion.end());
+
+  for (const auto& id : inRegion) {
+    auto index = model()->nodeIndex(id);
+
+    for (auto ty : {PortType::In, PortType::Out}) {
+      auto numPorts = model()->nodePortCount(index, ty);
+
+      for (auto portID = 0u; portID < numPorts; ++portID) {
+        for (const auto& conn : model()->nodePortConnections(index, ty, portID)) {
+          wantedNodes.insert(conn.first.id());
+        }
+      }
+    }
+  }
+
+  // release first, the memory goes to the new ones
+  std::vector<QUuid> released;
+  for (auto const& pair : _nodeGraphicsObjects) {
+    if (wantedNodes.count(pair.first) == 0 &&
+        !pair.second->isSelected() &&
+        !kept.contains(pair.second->pos())) {
+      released.push_back(pair.first);
+    }
+  }
+
+  for (const auto& id : released) {
+    releaseNode(id);
+  }
+
+  std::vector<QUuid> realized;
+  for (const auto& id : wantedNodes) {
+    if (_nodeGraphicsObjects.find(id) == _nodeGraphicsObjects.end()) {
+      realizeNode(id);
+      realized.push_back(id);
+    }
+  }
+
+  // connections once both ends exist
+  for (const auto& id : realized) {
+    realizeConnections(model()->nodeIndex(id));
+  }
+
+  _realizedRegion = wanted;
+}
+
+NodeGraphicsObject*
+FlowScene::
+realizeNode(QUuid const& id)
+{
+  auto index = model()->nodeIndex(id);
+  Q_ASSERT(index.isValid());
+
+  auto ngo = new NodeGraphicsObject(*this, index);
+  Q_ASSERT(ngo->scene() == this);
+
+  // ensure correct initial sizing (before first paint)
+  ngo->geometry().recalculateSize();
+
+  _nodeGraphicsObjects[id] = ngo;
+
+  adoptWidget(index);
+
+  ngo->setPos(model()->nodeLocation(index));
+
+  return ngo;
+}
+
+void
+FlowScene::
+adoptWidget(NodeIndex const& index)
+{
+  if (model()->nodeWidgetOwnedByModel(index)) {
+    return;
+  }
+
+  if (auto w = model()->nodeWidget(index)) {
+    _nodeWidgets[index.id()] = w;
+  }
+}
+
+void
+FlowScene::
+realizeConnections(NodeIndex const& index)
+{
+  for (auto ty : {PortType::In, PortType::Out}) {
+    auto numPorts = model()->nodePortCount(index, ty);
+
+    for (auto portID = 0u; portID < numPorts; ++portID) {
+      for (const auto& conn : model()->nodePortConnections(index, ty, portID)) {
+        if (ty == PortType::Out) {
+          connectionAdded(index, portID, conn.first, conn.second);
+        } else {
+          connectionAdded(conn.first, conn.second, index, portID);
+        }
+      }
+    }
+  }
+}
+
+void
+FlowScene::
+releaseNode(QUuid const& id)
+{
+  auto iter = _nodeGraphicsObjects.find(id);
+  if (iter == _nodeGraphicsObjects.end()) {
+    return;
+  }
+
+  releaseConnections(*iter->second);
+
+  delete iter->second;
+  _nodeGraphicsObjects.erase(iter);
+}
+
+void
+FlowScene::
+releaseConnections(NodeGraphicsObject& ngo)
+{
+  auto remConns = [&](PortType ty) {
+    for (auto i = 0ull; i < ngo.nodeState().getEntries(ty).size(); ++i) {
+
+      while (!ngo.nodeState().getEntries(ty)[i].empty()) {
+        
+        auto conn = ngo.nodeState().getEntries(ty)[i][0];
+        // remove it from the nodes
+        auto& otherNgo = *nodeGraphicsObject(conn->node(oppositePort(ty)));
+        otherNgo.nodeState().eraseConnection(oppositePort(ty), conn->portIndex(oppositePort(ty)), *conn);
+
+        auto& thisNgo = *nodeGraphicsObject(conn->node(ty));
+        thisNgo.nodeState().eraseConnection(ty, conn->portIndex(ty), *conn);
+
+        // remove the ConnectionGraphicsObject
+        _connGraphicsObjects.erase(conn->id());
+        delete conn;
+      }
+    }
+  };
+  remConns(PortType::In);
+  remConns(PortType::Out);
+}
+
+void
+FlowScene::
+indexNode(QUuid const& id, QPointF const& position)
+{
+  std::uint64_t const key = cellKey(position);
+
+  auto cell = _nodeCells.find(id);
+
+  if (cell != _nodeCells.end()) {
+    if (cell->second == key) {
+      return;
+    }
+
+    auto& ids = _grid[cell->second];
+    ids.erase(std::find(ids.begin(), ids.end(), id));
+    if (ids.empty()) {
+      _grid.erase(cell->second);
+    }
+
+    cell->second = key;
+  } else {
+    _nodeCells.emplace(id, key);
+  }
+
+  _grid[key].push_back(id);
+}
+
+void
+FlowScene::
+unindexNode(QUuid const& id)
+{
+  auto cell = _nodeCells.find(id);
+  if (cell == _nodeCells.end()) {
+    return;
+  }
+
+  auto& ids = _grid[cell->second];
+  ids.erase(std::find(ids.begin(), ids.end(), id));
+  if (ids.empty()) {
+    _grid.erase(cell->second);
+  }
+
+  _nodeCells.erase(cell);
+}
+
+std::vector<QUuid>
+FlowScene::
+indexedNodesIn(QRectF const& rect) const
+{
+  std::vector<QUuid> result;
+
+  // nodes are placed by their top left corner, take the cells above and to
+  // the left too so nodes reaching into `rect` are found
+  double const left   = std::floor(rect.left() / CellSize) - 1;
+  double const right  = std::floor(rect.right() / CellSize);
+  double const top    = std::floor(rect.top() / CellSize) - 1;
+  double const bottom = std::floor(rect.bottom() / CellSize);
+
+  // a huge rect visits the occupied cells rather than every cell in it
+  if ((right - left + 1) * (bottom - top + 1) > double(_grid.size())) {
+    for (auto const& cell : _grid) {
+      int const x = int(std::int32_t(std::uint32_t(cell.first >> 32)));
+      int const y = int(std::int32_t(std::uint32_t(cell.first)));
+
+      if (x >= left && x <= right && y >= top && y <= bottom) {
+        result.insert(result.end(), cell.second.begin(), cell.second.end());
+      }
+    }
+    return result;
+  }
+
+  for (int y = int(top); y <= int(bottom); ++y) {
+    for (int x = int(left); x <= int(right); ++x) {
+      auto iter = _grid.find(cellKey(x, y));
+
+      if (iter != _grid.end()) {
+        result.insert(result.end(), iter->second.begin(), iter->second.end());
+      }
+    }
+  }
+
+  return result;
+}
+
+void
+FlowScene::
+updateDetailLevel()
+{
+  qreal scale = 0.0;
+
+  for (QGraphicsView* view : views()) {
+    if (view->isVisible()) {
+      scale = std::max(scale, QStyleOptionGraphicsItem().levelOfDetailFromTransform(view->transform()));
+    }
+  }
+
+  // no view shows the scene, keep what there is
+  if (scale == 0.0) {
+    return;
+  }
+
+  DetailLevel const level = QtNodes::detailLevel(scale);
+
+  if (level == _detailLevel) {
+    return;
+  }
+
+  _detailLevel = level;
+
+  for (auto const& pair : _nodeGraphicsObjects) {
+    pair.second->setDetailLevel(level);
+  }
+}
+
+
+QRectF
+FlowScene::
+visibleRegion() const
+{
+  QRectF region;
+
+  for (QGraphicsView* view : views()) {
+    if (view->isVisible()) {
+      region |= view->mapToScene(view->viewport()->rect()).boundingRect();
+    }
+  }
+
+  return region;
+}
+
 
 void 
 FlowScene::
 nodeRemoved(const QUuid& id)
 {
-  auto ngo = _nodeGraphicsObjects[id];
+  unindexNode(id);
+
+  // deleted last, the graphics detach it first
+  std::unique_ptr<QWidget> removedWidget(_removedWidget);
+  _removedWidget = nullptr;
+
+  auto iter = _nodeGraphicsObjects.find(id);
+  if (iter == _nodeGraphicsObjects.end()) {
+    // released or never realized
+    return;
+  }
+
+  auto ngo = iter->second;
 #ifndef NDEBUG
   // make sure there are no connections left
 
@@ -113,8 +517,18 @@ nodeRemoved(const QUuid& id)
 
   // just delete it
   delete ngo;
-  auto erased = _nodeGraphicsObjects.erase(id);
-  Q_ASSERT(erased == 1);
+  _nodeGraphicsObjects.erase(iter);
+}
+void
+FlowScene::
+nodeAboutToBeRemoved(NodeIndex const& index)
+{
+  // the model may still use its widget while it is destroyed
+  auto iter = _nodeWidgets.find(index.id());
+  if (iter != _nodeWidgets.end()) {
+    _removedWidget = iter->second;
+    _nodeWidgets.erase(iter);
+  }
 }
 void
 FlowScene::
@@ -128,14 +542,18 @@ nodeAdded(const QUuid& newID)
   auto index = model()->nodeIndex(newID);
   Q_ASSERT(index.isValid());
 
-  auto ngo = new NodeGraphicsObject(*this, index);
-  Q_ASSERT(ngo->scene() == this);
+  // out of view, realized once the views get there
+  if (_virtualized) {
+    QPointF const location = model()->nodeLocation(index);
 
-  // ensure correct initial sizing (before first paint)
-  ngo->geometry().recalculateSize();
+    indexNode(newID, location);
 
-  _nodeGraphicsObjects[index.id()] = ngo;
+    if (!_realizedRegion.contains(location)) {
+      return;
+    }
+  }
 
+  realizeNode(newID);
   nodeMoved(index);
 }
 void
@@ -144,30 +562,13 @@ nodePortUpdated(NodeIndex const& id)
 {
   
   auto thisNodeNGO = nodeGraphicsObject(id);
-  Q_ASSERT(thisNodeNGO);
+  if (!thisNodeNGO) {
+    // not realized, nothing to update
+    return;
+  }
 
   // remove all the connections
-  auto remConns = [&](PortType ty) {
-    for (auto i = 0ull; i < thisNodeNGO->nodeState().getEntries(ty).size(); ++i) {
-
-      while (!thisNodeNGO->nodeState().getEntries(ty)[i].empty()) {
-        
-        auto conn = thisNodeNGO->nodeState().getEntries(ty)[i][0];
-        // remove it from the nodes
-        auto& otherNgo = *nodeGraphicsObject(conn->node(oppositePort(ty)));
-        otherNgo.nodeState().eraseConnection(oppositePort(ty), conn->portIndex(oppositePort(ty)), *conn);
-
-        auto& thisNgo = *nodeGraphicsObject(conn->node(ty));
-        thisNgo.nodeState().eraseConnection(ty, conn->portIndex(ty), *conn);
-
-        // remove the ConnectionGraphicsObject
-        _connGraphicsObjects.erase(conn->id());
-        delete conn;
-      }
-    }
-  };
-  remConns(PortType::In);
-  remConns(PortType::Out);
+  releaseConnections(*thisNodeNGO);
   
   // recreate the NGO
   
@@ -182,6 +583,8 @@ nodePortUpdated(NodeIndex const& id)
 
   _nodeGraphicsObjects[id.id()] = ngo;
 
+  adoptWidget(id);
+
   nodeMoved(id);
   
   // add the connections back
@@ -217,6 +620,10 @@ nodeValidationUpdated(NodeIndex const& id)
 {
   // repaint
   auto ngo = nodeGraphicsObject(id);
+  if (!ngo) {
+    return;
+  }
+  ngo->geometry().invalidateDescriptor();
   ngo->setGeometryChanged();
   ngo->geometry().recalculateSize();
   ngo->moveConnections();
@@ -246,8 +653,12 @@ connectionRemoved(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex con
   id.lPortID = leftPortID;
   id.rPortID = rightPortID;
   
-  // cgo
-  auto& cgo = *_connGraphicsObjects[id];
+  // cgo, if both ends were realized
+  auto iter = _connGraphicsObjects.find(id);
+  if (iter == _connGraphicsObjects.end()) {
+    return;
+  }
+  auto& cgo = *iter->second;
   
   // remove it from the nodes
   auto& lngo = *nodeGraphicsObject(leftNode);
@@ -290,14 +701,39 @@ connectionAdded(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const
   Q_ASSERT(checkedOut);
 #endif
   
+  // only between realized nodes, and once
+  auto lngo = nodeGraphicsObject(leftNode);
+  auto rngo = nodeGraphicsObject(rightNode);
+
+  if (!lngo || !rngo) {
+    if (!_virtualized || (!lngo && !rngo)) {
+      return;
+    }
+
+    // neighbours of realized nodes get graphics, see updateVisibleRegion
+    if (!lngo) {
+      lngo = realizeNode(leftNode.id());
+    } else {
+      rngo = realizeNode(rightNode.id());
+    }
+  }
+
+  ConnectionID id;
+  id.lNodeID = leftNode.id();
+  id.rNodeID = rightNode.id();
+  id.lPortID = leftPortID;
+  id.rPortID = rightPortID;
+
+  if (_connGraphicsObjects.find(id) != _connGraphicsObjects.end()) {
+    return;
+  }
+
   // create the cgo
   auto cgo = new ConnectionGraphicsObject(leftNode, leftPortID, rightNode, rightPortID, *this);
   
   // add it to the nodes
-  auto lngo = nodeGraphicsObject(leftNode);
   lngo->nodeState().setConnection(PortType::Out, leftPortID, *cgo);
   
-  auto rngo = nodeGraphicsObject(rightNode);
   rngo->nodeState().setConnection(PortType::In, rightPortID, *cgo);
   
   // add the cgo to the map
@@ -308,7 +744,41 @@ connectionAdded(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const
 void
 FlowScene::
 nodeMoved(NodeIndex const& index) {
-  _nodeGraphicsObjects[index.id()]->setPos(model()->nodeLocation(index));
+  QPointF const location = model()->nodeLocation(index);
+
+  if (_virtualized) {
+    indexNode(index.id(), location);
+  }
+
+  auto iter = _nodeGraphicsObjects.find(index.id());
+  if (iter != _nodeGraphicsObjects.end()) {
+    iter->second->setPos(location);
+    return;
+  }
+
+  // moved into view
+  if (_realizedRegion.contains(location)) {
+    realizeNode(index.id());
+    realizeConnections(index);
+  }
+}
+
+void
+FlowScene::
+modelReset() {
+  clearGraphics();
+
+  // nodes removed without signals take their widgets along
+  for (auto iter = _nodeWidgets.begin(); iter != _nodeWidgets.end(); ) {
+    if (!model()->nodeIndex(iter->first).isValid()) {
+      delete iter->second;
+      iter = _nodeWidgets.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  buildGraphics();
 }
 
 NodeGraphicsObject*
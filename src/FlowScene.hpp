@@ -6,12 +6,15 @@
 #include <unordered_map>
 #include <tuple>
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include <functional>
 
 #include "QUuidStdHash.hpp"
 #include "Export.hpp"
 #include "ConnectionID.hpp"
 #include "DataModelRegistry.hpp"
+#include "LevelOfDetail.hpp"
 
 namespace QtNodes
 {
@@ -38,20 +41,77 @@ public:
 
   FlowSceneModel* model() const { return _model; }
 
+  /// nullptr if the node has no graphics, see `setVirtualized`
   NodeGraphicsObject* nodeGraphicsObject(NodeIndex const& index) const { return nodeGraphicsObject(index.id()); }
   NodeGraphicsObject* nodeGraphicsObject(QUuid const& id) const;
   
   std::vector<NodeIndex> selectedNodes() const;
 
+  /// In virtualized mode graphics exist only for the nodes near the visible
+  /// area of the views, found through a grid of the node positions, and
+  /// for their direct neighbours so that connections leaving the area are
+  /// drawn. More are created as the views pan and zoom, and those well out
+  /// of view are released unless selected. Nodes added or moved into the
+  /// realized area get their graphics right away.
+  void setVirtualized(bool virtualized);
+
+  bool isVirtualized() const { return _virtualized; }
+
+  /// Creates and releases graphics for the area the views show now.
+  /// FlowView calls this as it pans, zooms and resizes.
+  void updateVisibleRegion();
+
+  std::size_t realizedNodeCount() const { return _nodeGraphicsObjects.size(); }
+
+  /// Tier the nodes are drawn at in the most zoomed in view
+  DetailLevel detailLevel() const { return _detailLevel; }
+
+  /// Follows the zoom of the views: below `DetailLevel::Full` the nodes
+  /// drop their drop shadows and embedded widgets, which cost the most in
+  /// an overview. FlowView calls this as it zooms.
+  void updateDetailLevel();
+
 private slots:
 
   void nodeRemoved(const QUuid& id);
   void nodeAdded(const QUuid& newID);
+  void nodeAboutToBeRemoved(NodeIndex const& index);
   void nodePortUpdated(NodeIndex const& id);
   void nodeValidationUpdated(NodeIndex const& id);
   void connectionRemoved(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const& rightNode, PortIndex rightPortID);
   void connectionAdded(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const& rightNode, PortIndex rightPortID);
   void nodeMoved(NodeIndex const& index);
+  void modelReset();
+
+private:
+
+  /// Creates the graphics objects of every node and connection in the model
+  void buildGraphics();
+
+  void clearGraphics();
+
+  NodeGraphicsObject* realizeNode(QUuid const& id);
+
+  /// Remembers the node's embedded widget for deletion with the node,
+  /// unless the model owns it
+  void adoptWidget(NodeIndex const& index);
+
+  /// Creates the graphics of the node's connections to realized nodes
+  void realizeConnections(NodeIndex const& index);
+
+  void releaseNode(QUuid const& id);
+
+  /// Deletes the graphics of all the connections of `ngo`
+  void releaseConnections(NodeGraphicsObject& ngo);
+
+  void indexNode(QUuid const& id, QPointF const& position);
+
+  void unindexNode(QUuid const& id);
+
+  std::vector<QUuid> indexedNodesIn(QRectF const& rect) const;
+
+  /// Union of what the visible views show
+  QRectF visibleRegion() const;
 
 private:
 
@@ -60,9 +120,26 @@ private:
   std::unordered_map<QUuid, NodeGraphicsObject*> _nodeGraphicsObjects;
   std::unordered_map<ConnectionID, ConnectionGraphicsObject*> _connGraphicsObjects;
 
+  // embedded widgets owned by the scene, they outlive released graphics
+  std::unordered_map<QUuid, QWidget*> _nodeWidgets;
+
+  // widget of the node being removed, deleted once the model let go of it
+  QWidget* _removedWidget = nullptr;
+
   // This is for when you're creating a connection
   ConnectionGraphicsObject* _temporaryConn = nullptr;
 
+  bool _virtualized = false;
+
+  // node ids by grid cell of their position, virtualized mode only
+  std::unordered_map<std::uint64_t, std::vector<QUuid>> _grid;
+  std::unordered_map<QUuid, std::uint64_t>              _nodeCells;
+
+  // realized area with some margin, where moved nodes get graphics
+  QRectF _realizedRegion;
+
+  DetailLevel _detailLevel = DetailLevel::Full;
+
 };
 
 NodeGraphicsObject*
@@ -1,5 +1,8 @@
 #include "FlowSceneModel.hpp"
 #include "NodeIndex.hpp"
+#include "NodeDescriptor.hpp"
+
+#include <atomic>
 
 namespace QtNodes {
 
@@ -40,6 +43,43 @@ bool FlowSceneModel::removeNodeWithConnections(NodeIndex const& index) {
   return removeNode(index);
 }
 
+std::shared_ptr<NodeDescriptor const> FlowSceneModel::nodeDescriptor(NodeIndex const& index) const
+{
+  Q_ASSERT(index.isValid());
+
+  auto descriptor = std::make_shared<NodeDescriptor>();
+
+  descriptor->version           = nextDescriptorVersion();
+  descriptor->caption           = nodeCaption(index);
+  descriptor->resizable         = nodeResizable(index);
+  descriptor->validationState   = nodeValidationState(index);
+  descriptor->validationMessage = nodeValidationMessage(index);
+  descriptor->style             = nodeStyle(index);
+
+  auto fillPorts = [&](PortType ty, std::vector<PortDescriptor>& ports) {
+    auto count = nodePortCount(index, ty);
+    ports.resize(count);
+    for (PortIndex portID = 0; (unsigned)portID < count; ++portID) {
+      auto& port = ports[portID];
+
+      port.caption          = nodePortCaption(index, ty, portID);
+      port.dataType         = nodePortDataType(index, ty, portID);
+      port.connectionPolicy = nodePortConnectionPolicy(index, ty, portID);
+    }
+  };
+  fillPorts(PortType::In, descriptor->inPorts);
+  fillPorts(PortType::Out, descriptor->outPorts);
+
+  return descriptor;
+}
+
+std::size_t FlowSceneModel::nextDescriptorVersion()
+{
+  static std::atomic<std::size_t> version{0};
+
+  return ++version;
+}
+
 NodeIndex FlowSceneModel::createIndex(const QUuid& id, void* internalPointer) const
 {
   return NodeIndex(id, internalPointer, this);
@@ -6,8 +6,10 @@
 #include "StyleCollection.hpp"
 
 #include <cstddef>
+#include <memory>
 
 #include <QString>
+#include <QStringList>
 #include <QPointF>
 #include <QObject>
 #include <QUuid>
@@ -19,6 +21,7 @@ namespace QtNodes
 
 class NodeIndex;
 struct NodeDataType;
+struct NodeDescriptor;
 class NodePainterDelegate;
 
 enum class ConnectionPolicy {
@@ -46,6 +49,10 @@ public:
   // Scene specific functions
   virtual QStringList modelRegistry() const = 0;
 
+  /// Changes whenever `modelRegistry()` gains models, for views caching
+  /// it; `modelRegistryChanged` covers replacing the registry
+  virtual std::size_t modelRegistryGeneration() const { return 0; }
+
   /// Get the category for a node type
   /// name will be from `modelRegistry()`
   virtual QString nodeTypeCategory(QString const& /*name*/) const { return {}; }
@@ -53,6 +60,21 @@ public:
   /// Get the conerter node type name, or "" if there is none.
   virtual QString converterNode(NodeDataType const& /*lhs*/, NodeDataType const& ) const { return {}; }
 
+  /// Get the node type names that convert `lhs` into `rhs` when connected
+  /// one after another, or an empty list if there is no such chain.
+  /// Defaults to the single converter from `converterNode`.
+  virtual QStringList converterNodeChain(NodeDataType const& lhs, NodeDataType const& rhs) const {
+    QString converter = converterNode(lhs, rhs);
+    return converter.isEmpty() ? QStringList{} : QStringList{converter};
+  }
+
+  /// Whether `converterNodeChain(lhs, rhs)` is non-empty. Asked for every
+  /// port on every repaint while a connection is dragged, so models with a
+  /// cheaper answer should override it.
+  virtual bool typesConvertible(NodeDataType const& lhs, NodeDataType const& rhs) const {
+    return !converterNodeChain(lhs, rhs).isEmpty();
+  }
+
   // Retrieval functions
   //////////////////////
 
@@ -73,6 +95,12 @@ public:
 
   /// Get the embedded widget
   virtual QWidget* nodeWidget(NodeIndex const& index) const = 0;
+
+  /// Whether the embedded widget outlives the node, e.g. because the model
+  /// behind it gets reused. Otherwise the view deletes the widget once the
+  /// node is removed; releasing or rebuilding a node's graphics only
+  /// detaches it.
+  virtual bool nodeWidgetOwnedByModel(NodeIndex const& /*index*/) const { return false; }
   
   /// Get if it's resizable
   virtual bool nodeResizable(NodeIndex const& index) const = 0;
@@ -104,6 +132,13 @@ public:
   /// Get a connection at a port
   virtual std::vector<std::pair<NodeIndex, PortIndex>> nodePortConnections(NodeIndex const& index, PortType portTypes, PortIndex portID) const = 0;
 
+  /// Get caption, ports, style and validation of a node in one query.
+  /// The default implementation assembles it from the getters above; views
+  /// cache the result until `nodePortUpdated` or `nodeValidationUpdated`
+  /// is emitted for the node. Models whose captions change with their data
+  /// emit `nodeValidationUpdated` for that as well.
+  virtual std::shared_ptr<NodeDescriptor const> nodeDescriptor(NodeIndex const& index) const;
+
   // Mutation functions
   /////////////////////
 
@@ -158,10 +193,20 @@ signals:
   void connectionAdded(NodeIndex const& leftNode, PortIndex leftPortID, NodeIndex const& rightNode, PortIndex rightPortID);
   void nodeMoved(NodeIndex const& index);
 
+  /// The set of creatable models or their categories changed
+  void modelRegistryChanged();
+
+  /// Nodes and connections changed without the signals above, e.g. during
+  /// a bulk load; views rebuild everything from the model
+  void modelReset();
+
 protected:
 
   NodeIndex createIndex(const QUuid& id, void* internalPointer) const;
 
+  /// Version to stamp on a freshly built NodeDescriptor
+  static std::size_t nextDescriptorVersion();
+
 };
 
 } // namespace QtNodes
@@ -17,6 +17,7 @@
 #include <cmath>
 
 #include "FlowScene.hpp"
+#include "FlowSceneModel.hpp"
 #include "DataModelRegistry.hpp"
 #include "Node.hpp"
 #include "NodeGraphicsObject.hpp"
@@ -31,6 +32,13 @@ FlowView(QWidget *parent)
   : QGraphicsView(parent)
   , _clearSelectionAction(Q_NULLPTR)
   , _deleteSelectionAction(Q_NULLPTR)
+  , _modelMenu(Q_NULLPTR)
+  , _filterEdit(Q_NULLPTR)
+  , _modelTree(Q_NULLPTR)
+  , _modelTreeAction(Q_NULLPTR)
+  , _resultList(Q_NULLPTR)
+  , _resultListAction(Q_NULLPTR)
+  , _paletteDirty(true)
   , _scene(Q_NULLPTR)
 {
   setDragMode(QGraphicsView::ScrollHandDrag);
@@ -83,6 +91,15 @@ FlowView::setScene(FlowScene *scene)
   _scene = scene;
   QGraphicsView::setScene(_scene);
 
+  // the palette is rebuilt lazily, on the next context menu
+  _paletteDirty = true;
+  disconnect(_registryChangedConnection);
+  if (_scene)
+  {
+    _registryChangedConnection = connect(_scene->model(), &FlowSceneModel::modelRegistryChanged,
+                                         this, [this]{ _paletteDirty = true; });
+  }
+
   // setup actions
   delete _clearSelectionAction;
   _clearSelectionAction = new QAction(QStringLiteral("Clear Selection"), this);
@@ -108,113 +125,175 @@ contextMenuEvent(QContextMenuEvent *event)
     return;
   }
 
-  QMenu modelMenu;
+  if (!_modelMenu)
+  {
+    buildModelMenu();
+  }
 
-  auto skipText = QStringLiteral("skip me");
+  // models may have been registered since, without a signal
+  if (_paletteDirty || _paletteGeneration != _scene->model()->modelRegistryGeneration())
+  {
+    refreshModelPalette();
+  }
+
+  _contextMenuPos = mapToScene(event->pos());
+
+  _filterEdit->clear();
+  filterModelMenu(QString());
+
+  // make sure the text box gets focus so the user doesn't have to click on it
+  _filterEdit->setFocus();
+
+  _modelMenu->exec(event->globalPos());
+}
+
+
+void
+FlowView::
+buildModelMenu()
+{
+  _modelMenu = new QMenu(this);
 
   //Add filterbox to the context menu
-  auto *txtBox = new QLineEdit(&modelMenu);
+  _filterEdit = new QLineEdit(_modelMenu);
 
-  txtBox->setPlaceholderText(QStringLiteral("Filter"));
-  txtBox->setClearButtonEnabled(true);
+  _filterEdit->setPlaceholderText(QStringLiteral("Filter"));
+  _filterEdit->setClearButtonEnabled(true);
 
-  auto *txtBoxAction = new QWidgetAction(&modelMenu);
-  txtBoxAction->setDefaultWidget(txtBox);
+  auto *txtBoxAction = new QWidgetAction(_modelMenu);
+  txtBoxAction->setDefaultWidget(_filterEdit);
 
-  modelMenu.addAction(txtBoxAction);
+  _modelMenu->addAction(txtBoxAction);
 
-  //Add result treeview to the context menu
-  auto *treeView = new QTreeWidget(&modelMenu);
-  treeView->header()->close();
+  //Add the category tree, shown while there is no filter
+  _modelTree = new QTreeWidget(_modelMenu);
+  _modelTree->header()->close();
 
-  auto *treeViewAction = new QWidgetAction(&modelMenu);
-  treeViewAction->setDefaultWidget(treeView);
+  _modelTreeAction = new QWidgetAction(_modelMenu);
+  _modelTreeAction->setDefaultWidget(_modelTree);
 
-  modelMenu.addAction(treeViewAction);
+  _modelMenu->addAction(_modelTreeAction);
 
-  std::unordered_map<QString, QTreeWidgetItem*> categoryItems;
-  for (auto const &modelName : _scene->model()->modelRegistry())
-  {
-    // get the category
-    auto category = _scene->model()->nodeTypeCategory(modelName);
-    
-    // see if it's already in the map
-    auto iter = categoryItems.find(category);
-    
-    // add it if it doesn't exist
-    if (iter == categoryItems.end()) {
-        
-        auto item = new QTreeWidgetItem(treeView);
-        item->setText(0, category);
-        item->setData(0, Qt::UserRole, skipText);
-        
-        iter = categoryItems.emplace(category, item).first; 
-    }
-    
-    // this is the category item
-    auto parent = iter->second;
-    
-    // add the item
-    
-
-    auto item   = new QTreeWidgetItem(parent);
-    item->setText(0, modelName);
-    item->setData(0, Qt::UserRole, modelName);
-  }
+  //Add the ranked search results, shown while filtering
+  _resultList = new QListWidget(_modelMenu);
 
-  treeView->expandAll();
+  _resultListAction = new QWidgetAction(_modelMenu);
+  _resultListAction->setDefaultWidget(_resultList);
 
-  connect(treeView, &QTreeWidget::itemClicked, [&](QTreeWidgetItem *item)
+  _modelMenu->addAction(_resultListAction);
+
+  // category items carry no model name
+  connect(_modelTree, &QTreeWidget::itemClicked, this, [this](QTreeWidgetItem *item)
   {
-    QString modelName = item->data(0, Qt::UserRole).toString();
+    QVariant modelName = item->data(0, Qt::UserRole);
 
-    if (modelName == skipText)
+    if (modelName.isValid())
     {
-      return;
+      createNodeFromMenu(modelName.toString());
     }
+  });
 
-    QPoint pos = event->pos();
-
-    QPointF posView = this->mapToScene(pos);
+  connect(_resultList, &QListWidget::itemClicked, this, [this](QListWidgetItem *item)
+  {
+    createNodeFromMenu(item->data(Qt::UserRole).toString());
+  });
 
-    modelMenu.close();
+  connect(_filterEdit, &QLineEdit::textChanged, this, &FlowView::filterModelMenu);
 
-    // try to create the node
-    auto uuid = _scene->model()->addNode(modelName, posView);
-    
-    // if the node creation failed, then don't add it
-    if (!uuid.isNull()) {
-        // move it to the cursor location
-        _scene->model()->moveNode(_scene->model()->nodeIndex(uuid), posView);
+  // enter picks the best match
+  connect(_filterEdit, &QLineEdit::returnPressed, this, [this]
+  {
+    if (_resultListAction->isVisible() && _resultList->currentItem())
+    {
+      createNodeFromMenu(_resultList->currentItem()->data(Qt::UserRole).toString());
     }
-
   });
+}
 
-  //Setup filtering
-  connect(txtBox, &QLineEdit::textChanged, [&](const QString &text)
+
+void
+FlowView::
+refreshModelPalette()
+{
+  _palette.rebuild(*_scene->model());
+  _paletteGeneration = _scene->model()->modelRegistryGeneration();
+
+  _modelTree->clear();
+
+  QTreeWidgetItem* categoryItem = nullptr;
+
+  for (std::size_t index : _palette.byCategory())
   {
-    for (auto& topLvlItem : categoryItems)
+    auto const& entry = _palette.entries()[index];
+
+    // entries come grouped by category
+    if (!categoryItem || categoryItem->text(0) != entry.category)
     {
-      for (int i = 0; i < topLvlItem.second->childCount(); ++i)
-      {
-        auto child = topLvlItem.second->child(i);
-        auto modelName = child->data(0, Qt::UserRole).toString();
-        if (modelName.contains(text, Qt::CaseInsensitive))
-        {
-          child->setHidden(false);
-        }
-        else
-        {
-          child->setHidden(true);
-        }
-      }
+      categoryItem = new QTreeWidgetItem(_modelTree);
+      categoryItem->setText(0, entry.category);
     }
-  });
 
-  // make sure the text box gets focus so the user doesn't have to click on it
-  txtBox->setFocus();
+    auto item = new QTreeWidgetItem(categoryItem);
+    item->setText(0, entry.name);
+    item->setData(0, Qt::UserRole, entry.name);
+  }
+
+  _modelTree->expandAll();
+
+  _paletteDirty = false;
+}
+
+
+void
+FlowView::
+filterModelMenu(QString const& text)
+{
+  // enough to fill the list, the rest is reachable by typing more
+  std::size_t const maxResults = 50;
+
+  bool const filtering = !text.isEmpty();
+
+  _modelTreeAction->setVisible(!filtering);
+  _resultListAction->setVisible(filtering);
+
+  _resultList->clear();
+
+  if (!filtering)
+  {
+    // forget the previous query, the next one starts from scratch
+    _palette.match(text);
+    return;
+  }
+
+  auto const& matches = _palette.match(text);
+
+  for (std::size_t i = 0; i < matches.size() && i < maxResults; ++i)
+  {
+    auto const& entry = _palette.entries()[matches[i]];
+
+    auto item = new QListWidgetItem(entry.name, _resultList);
+    item->setData(Qt::UserRole, entry.name);
+    item->setToolTip(entry.category);
+  }
 
-  modelMenu.exec(event->globalPos());
+  _resultList->setCurrentRow(0);
+}
+
+
+void
+FlowView::
+createNodeFromMenu(QString const& modelName)
+{
+  _modelMenu->close();
+
+  // try to create the node
+  auto uuid = _scene->model()->addNode(modelName, _contextMenuPos);
+
+  // if the node creation failed, then don't add it
+  if (!uuid.isNull()) {
+      // move it to the cursor location
+      _scene->model()->moveNode(_scene->model()->nodeIndex(uuid), _contextMenuPos);
+  }
 }
 
 
@@ -252,6 +331,9 @@ scaleUp()
     return;
 
   scale(factor, factor);
+
+  _scene->updateVisibleRegion();
+  _scene->updateDetailLevel();
 }
 
 
@@ -263,6 +345,9 @@ scaleDown()
   double const factor = std::pow(step, -1.0);
 
   scale(factor, factor);
+
+  _scene->updateVisibleRegion();
+  _scene->updateDetailLevel();
 }
 
 
@@ -349,6 +434,8 @@ mouseMoveEvent(QMouseEvent *event)
       {
           QPointF difference = _clickPos - mapToScene(event->pos());
           setSceneRect(sceneRect().translated(difference.x(), difference.y()));
+
+          _scene->updateVisibleRegion();
       }
   }
 }
@@ -411,6 +498,19 @@ showEvent(QShowEvent *event)
 {
   _scene->setSceneRect(this->rect());
   QGraphicsView::showEvent(event);
+
+  _scene->updateVisibleRegion();
+}
+
+
+void
+FlowView::
+resizeEvent(QResizeEvent *event)
+{
+  QGraphicsView::resizeEvent(event);
+
+  if (_scene)
+    _scene->updateVisibleRegion();
 }
 
 FlowScene*
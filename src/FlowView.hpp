@@ -3,6 +3,13 @@
 #include <QtWidgets/QGraphicsView>
 
 #include "Export.hpp"
+#include "ModelPalette.hpp"
+
+class QMenu;
+class QLineEdit;
+class QTreeWidget;
+class QListWidget;
+class QWidgetAction;
 
 namespace QtNodes
 {
@@ -55,10 +62,24 @@ protected:
 
   void showEvent(QShowEvent *event) override;
 
+  void resizeEvent(QResizeEvent *event) override;
+
 protected:
 
   FlowScene * scene();
 
+private:
+
+  /// Creates the context menu widgets, kept for the lifetime of the view
+  void buildModelMenu();
+
+  /// Re-reads the models from the scene into the palette and the tree
+  void refreshModelPalette();
+
+  void filterModelMenu(QString const& text);
+
+  void createNodeFromMenu(QString const& modelName);
+
 private:
 
   QAction* _clearSelectionAction;
@@ -66,6 +87,23 @@ private:
 
   QPointF _clickPos;
 
+  // context menu listing the models, by category or by search rank
+  QMenu*         _modelMenu;
+  QLineEdit*     _filterEdit;
+  QTreeWidget*   _modelTree;
+  QWidgetAction* _modelTreeAction;
+  QListWidget*   _resultList;
+  QWidgetAction* _resultListAction;
+
+  ModelPalette _palette;
+  bool         _paletteDirty;
+  std::size_t  _paletteGeneration = 0;
+
+  QMetaObject::Connection _registryChangedConnection;
+
+  // where the node picked from the context menu goes
+  QPointF _contextMenuPos;
+
   FlowScene* _scene;
 };
 }
@@ -0,0 +1,1063 @@
+#include "GraphImporter.hpp"
+
+#include <memory>
+#include <vector>
+#include <unordered_set>
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QIODevice>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPointF>
+#include <QtCore/QStringList>
+#include <QtCore/QUuid>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QDebug>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "DataModelRegistry.hpp"
+#include "NodeDataModel.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+/// Receives the nodes and edges from the parsers and adds them to the model
+class ImportSink
+{
+public:
+
+  ImportSink(GraphImporter& importer, DataFlowModel& model)
+    : _importer(importer)
+    , _model(model)
+  {}
+
+  /// Declares a node, later declarations of the same node are ignored
+  void
+  node(QString const& name, QJsonObject attributes, QPointF const* position)
+  {
+    if (_ids.count(name) != 0 || _skippedNodes.count(name) != 0)
+      return;
+
+    _mentioned.erase(name);
+
+    QString const type      = attributes.value(_importer._typeAttribute).toString();
+    QString const modelName = _importer.modelFor(type);
+
+    auto model = _model._registry->create(modelName);
+
+    if (!model)
+    {
+      if (_warnedTypes.insert(type).second)
+        qWarning() << "No model for imported node type" << type;
+
+      _skippedNodes.insert(name);
+      ++_importer._skipped;
+
+      dropPending(name);
+      return;
+    }
+
+    if (!attributes.isEmpty())
+      model->restore(attributes);
+
+    auto& node = _model.addNode(std::move(model), QUuid::createUuid(),
+                                position ? *position : QPointF());
+    _ids[name] = node.id();
+
+    ++_importer._nodesImported;
+
+    // edges that were waiting for this node
+    auto pending = _pending.find(name);
+    if (pending != _pending.end())
+    {
+      std::vector<PendingEdge> edges = std::move(pending->second);
+      _pending.erase(pending);
+
+      for (auto const& e : edges)
+        edge(e.source, e.sourcePort, e.target, e.targetPort);
+    }
+  }
+
+  /// Remembers `defaults` for a node used before or without a declaration
+  void
+  mention(QString const& name, QJsonObject const& defaults)
+  {
+    if (_ids.count(name) == 0 && _skippedNodes.count(name) == 0)
+      _mentioned.emplace(name, defaults);
+  }
+
+  void
+  edge(QString const& source, PortIndex sourcePort,
+       QString const& target, PortIndex targetPort)
+  {
+    if (_skippedNodes.count(source) != 0 || _skippedNodes.count(target) != 0)
+    {
+      ++_importer._skipped;
+      return;
+    }
+
+    auto sourceID = _ids.find(source);
+    auto targetID = _ids.find(target);
+
+    if (sourceID == _ids.end() || targetID == _ids.end())
+    {
+      QString const& missing = sourceID == _ids.end() ? source : target;
+      _pending[missing].push_back(PendingEdge{source, sourcePort, target, targetPort});
+      return;
+    }
+
+    NodeIndex const sourceIndex = _model.nodeIndex(sourceID->second);
+    NodeIndex const targetIndex = _model.nodeIndex(targetID->second);
+
+    // ports come from the file, they may not exist or be taken already;
+    // repeated edges are allowed in both formats
+    if (!takesConnection(sourceIndex, PortType::Out, sourcePort) ||
+        !takesConnection(targetIndex, PortType::In, targetPort))
+    {
+      ++_importer._skipped;
+      return;
+    }
+
+    NodeDataType const sourceType = _model.nodePortDataType(sourceIndex, PortType::Out, sourcePort);
+    NodeDataType const targetType = _model.nodePortDataType(targetIndex, PortType::In, targetPort);
+
+    bool connected = false;
+
+    if (sourceType.id == targetType.id)
+      connected = _model.addConnection(sourceIndex, sourcePort, targetIndex, targetPort);
+    else if (_model.typesConvertible(sourceType, targetType))
+      connected = convert(sourceIndex, sourcePort, targetIndex, targetPort,
+                          _model.converterNodeChain(sourceType, targetType));
+
+    if (connected)
+      ++_importer._connectionsImported;
+    else
+      ++_importer._skipped;
+  }
+
+  /// Creates the nodes that were only referenced
+  void
+  finish()
+  {
+    // every round declares or skips a node, edges retried may wait for
+    // another one though
+    while (!_pending.empty() || !_mentioned.empty())
+    {
+      std::vector<QString> undeclared;
+      undeclared.reserve(_pending.size() + _mentioned.size());
+
+      for (auto const& pair : _pending)
+        undeclared.push_back(pair.first);
+
+      for (auto const& pair : _mentioned)
+        undeclared.push_back(pair.first);
+
+      for (QString const& name : undeclared)
+      {
+        auto mentioned = _mentioned.find(name);
+
+        node(name, mentioned != _mentioned.end() ? mentioned->second : QJsonObject(), nullptr);
+      }
+    }
+  }
+
+private:
+
+  /// Whether `port` exists and its policy allows one more connection
+  bool
+  takesConnection(NodeIndex const& index, PortType portType, PortIndex port) const
+  {
+    if (port < 0 || unsigned(port) >= _model.nodePortCount(index, portType))
+      return false;
+
+    return _model.nodePortConnectionPolicy(index, portType, port) != ConnectionPolicy::One ||
+           _model.nodePortConnections(index, portType, port).empty();
+  }
+
+  /// Connects through the converter models of `chain`, placed between the
+  /// two nodes, like an interactive connection does
+  bool
+  convert(NodeIndex const& sourceIndex, PortIndex sourcePort,
+          NodeIndex const& targetIndex, PortIndex targetPort,
+          QStringList const& chain)
+  {
+    std::vector<std::unique_ptr<NodeDataModel>> converters;
+
+    for (QString const& modelName : chain)
+    {
+      converters.push_back(_model._registry->create(modelName));
+
+      if (!converters.back())
+        return false;
+    }
+
+    QPointF const from = _model.nodeLocation(sourceIndex);
+    QPointF const to   = _model.nodeLocation(targetIndex);
+
+    NodeIndex upstream     = sourceIndex;
+    PortIndex upstreamPort = sourcePort;
+
+    for (std::size_t i = 0; i < converters.size(); ++i)
+    {
+      double const t = double(i + 1) / double(converters.size() + 1);
+
+      auto& node = _model.addNode(std::move(converters[i]), QUuid::createUuid(),
+                                  from + (to - from) * t);
+
+      NodeIndex const converter = _model.nodeIndex(node.id());
+
+      _model.addConnection(upstream, upstreamPort, converter, 0);
+
+      upstream     = converter;
+      upstreamPort = 0;
+    }
+
+    return _model.addConnection(upstream, upstreamPort, targetIndex, targetPort);
+  }
+
+  void
+  dropPending(QString const& name)
+  {
+    auto pending = _pending.find(name);
+    if (pending == _pending.end())
+      return;
+
+    _importer._skipped += pending->second.size();
+    _pending.erase(pending);
+  }
+
+private:
+
+  struct PendingEdge
+  {
+    QString   source;
+    PortIndex sourcePort;
+    QString   target;
+    PortIndex targetPort;
+  };
+
+  GraphImporter& _importer;
+  DataFlowModel& _model;
+
+  std::unordered_map<QString, QUuid> _ids;
+  std::unordered_set<QString>        _skippedNodes;
+  std::unordered_set<QString>        _warnedTypes;
+
+  // edges by the node they wait for
+  std::unordered_map<QString, std::vector<PendingEdge>> _pending;
+
+  // defaults of nodes referenced by edges before any declaration
+  std::unordered_map<QString, QJsonObject> _mentioned;
+};
+
+namespace
+{
+
+PortIndex
+portIndex(QString const& port)
+{
+  bool ok = false;
+  int const index = port.toInt(&ok);
+
+  return ok && index >= 0 ? PortIndex(index) : PortIndex(0);
+}
+
+
+/// Splits DOT input into tokens, reading the device a buffer at a time
+class DotLexer
+{
+public:
+
+  enum class Token
+  {
+    End,
+    Error,
+    Id,
+    LeftBrace,
+    RightBrace,
+    LeftBracket,
+    RightBracket,
+    Semicolon,
+    Comma,
+    Equals,
+    Colon,
+    EdgeOp
+  };
+
+public:
+
+  explicit
+  DotLexer(QIODevice& device)
+    : _device(device)
+  {}
+
+  Token
+  next()
+  {
+    _text.clear();
+    _quoted = false;
+
+    if (!skipSpaceAndComments())
+    {
+      _text = QStringLiteral("unexpected character '/'");
+      return Token::Error;
+    }
+
+    int const c = get();
+
+    switch (c)
+    {
+      case -1:  return Token::End;
+      case '{': return Token::LeftBrace;
+      case '}': return Token::RightBrace;
+      case '[': return Token::LeftBracket;
+      case ']': return Token::RightBracket;
+      case ';': return Token::Semicolon;
+      case ',': return Token::Comma;
+      case '=': return Token::Equals;
+      case ':': return Token::Colon;
+      case '"': return quotedString();
+      case '<': return htmlString();
+      default:  break;
+    }
+
+    if (c == '-' && (peek() == '>' || peek() == '-'))
+    {
+      get();
+      return Token::EdgeOp;
+    }
+
+    if (isIdChar(c) || c == '-' || c == '.')
+    {
+      QByteArray id(1, char(c));
+
+      while (isIdChar(peek()) || peek() == '.')
+        id.append(char(get()));
+
+      _text = QString::fromUtf8(id);
+      return Token::Id;
+    }
+
+    _text = QStringLiteral("unexpected character '%1'").arg(QChar(c));
+    return Token::Error;
+  }
+
+  /// Id text, or the message of an Error
+  QString const&
+  text() const { return _text; }
+
+  /// Quoted ids are never keywords
+  bool
+  quoted() const { return _quoted; }
+
+  int
+  line() const { return _line; }
+
+private:
+
+  static bool
+  isIdChar(int c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+  }
+
+  int
+  peek()
+  {
+    if (_position == _buffer.size())
+    {
+      _buffer   = _device.read(1 << 16);
+      _position = 0;
+    }
+
+    return _position < _buffer.size() ? uchar(_buffer[_position]) : -1;
+  }
+
+  int
+  get()
+  {
+    int const c = peek();
+
+    if (c != -1)
+    {
+      ++_position;
+
+      if (c == '\n')
+        ++_line;
+    }
+
+    return c;
+  }
+
+  void
+  skipLine()
+  {
+    int c;
+    while ((c = get()) != -1 && c != '\n') {}
+  }
+
+  /// False on a slash starting no comment
+  bool
+  skipSpaceAndComments()
+  {
+    for (;;)
+    {
+      int const c = peek();
+
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+      {
+        get();
+        _lineStart = _lineStart || c == '\n';
+        continue;
+      }
+
+      // C preprocessor output
+      if (c == '#' && _lineStart)
+      {
+        skipLine();
+        continue;
+      }
+
+      if (c != '/')
+        break;
+
+      get();
+
+      if (peek() == '/')
+      {
+        skipLine();
+      }
+      else if (peek() == '*')
+      {
+        get();
+
+        int previous = 0, current;
+        while ((current = get()) != -1 && !(previous == '*' && current == '/'))
+          previous = current;
+      }
+      else
+      {
+        return false;
+      }
+    }
+
+    _lineStart = false;
+    return true;
+  }
+
+  Token
+  quotedString()
+  {
+    QByteArray id;
+
+    for (;;)
+    {
+      int c = get();
+
+      if (c == -1)
+      {
+        _text = QStringLiteral("unterminated string");
+        return Token::Error;
+      }
+
+      if (c == '"')
+        break;
+
+      if (c == '\\')
+      {
+        int const escaped = get();
+
+        // an escaped quote, or a line continuation which is dropped
+        if (escaped == '"')
+          c = '"';
+        else if (escaped == '\n')
+          continue;
+        else
+        {
+          id.append('\\');
+          c = escaped;
+        }
+      }
+
+      id.append(char(c));
+    }
+
+    _text   = QString::fromUtf8(id);
+    _quoted = true;
+
+    return Token::Id;
+  }
+
+  Token
+  htmlString()
+  {
+    QByteArray id;
+    int depth = 1;
+
+    for (;;)
+    {
+      int const c = get();
+
+      if (c == -1)
+      {
+        _text = QStringLiteral("unterminated HTML string");
+        return Token::Error;
+      }
+
+      if (c == '<')
+        ++depth;
+      else if (c == '>' && --depth == 0)
+        break;
+
+      id.append(char(c));
+    }
+
+    _text   = QString::fromUtf8(id);
+    _quoted = true;
+
+    return Token::Id;
+  }
+
+private:
+
+  QIODevice& _device;
+
+  QByteArray _buffer;
+  int        _position = 0;
+
+  int  _line      = 1;
+  bool _lineStart = true;
+
+  QString _text;
+  bool    _quoted = false;
+};
+
+
+/// Recursive descent over the DOT grammar, handing each statement to the
+/// sink as soon as it is parsed
+class DotParser
+{
+public:
+
+  DotParser(QIODevice& device, ImportSink& sink)
+    : _lexer(device)
+    , _sink(sink)
+  {
+    advance();
+  }
+
+  bool
+  parse()
+  {
+    if (isKeyword("strict"))
+      advance();
+
+    if (!isKeyword("graph") && !isKeyword("digraph"))
+      return fail(QStringLiteral("expected 'graph' or 'digraph'"));
+
+    advance();
+
+    if (_token == DotLexer::Token::Id)
+      advance();
+
+    return block();
+  }
+
+  QString
+  errorString() const { return _error; }
+
+private:
+
+  using Token = DotLexer::Token;
+
+  struct Endpoint
+  {
+    QString   name;
+    PortIndex port;
+  };
+
+  void
+  advance()
+  {
+    _token = _lexer.next();
+
+    if (_token == Token::Error)
+      fail(_lexer.text());
+  }
+
+  bool
+  isKeyword(char const* keyword) const
+  {
+    return _token == Token::Id && !_lexer.quoted() &&
+           _lexer.text().compare(QLatin1String(keyword), Qt::CaseInsensitive) == 0;
+  }
+
+  bool
+  fail(QString const& message)
+  {
+    if (_error.isEmpty())
+      _error = QStringLiteral("line %1: %2").arg(_lexer.line()).arg(message);
+
+    _token = Token::Error;
+    return false;
+  }
+
+  bool
+  expect(Token token, char const* what)
+  {
+    if (_token != token)
+      return fail(QStringLiteral("expected %1").arg(QLatin1String(what)));
+
+    advance();
+    return true;
+  }
+
+  /// `{ statements }`, node defaults are scoped to it
+  bool
+  block()
+  {
+    if (!expect(Token::LeftBrace, "'{'"))
+      return false;
+
+    QJsonObject const outerDefaults = _nodeDefaults;
+
+    while (_token != Token::RightBrace)
+    {
+      if (_token == Token::End || _token == Token::Error || !statement())
+        return fail(QStringLiteral("expected '}'"));
+
+      if (_token == Token::Semicolon)
+        advance();
+    }
+
+    _nodeDefaults = outerDefaults;
+
+    advance();
+    return true;
+  }
+
+  bool
+  statement()
+  {
+    if (isKeyword("node") || isKeyword("edge") || isKeyword("graph"))
+    {
+      bool const nodeDefaults = isKeyword("node");
+      advance();
+
+      QJsonObject attributes;
+      if (!attributeLists(attributes))
+        return false;
+
+      if (nodeDefaults)
+      {
+        for (auto iter = attributes.begin(); iter != attributes.end(); ++iter)
+          _nodeDefaults[iter.key()] = iter.value();
+      }
+
+      return true;
+    }
+
+    if (isKeyword("subgraph") || _token == Token::LeftBrace)
+      return subgraph();
+
+    if (_token != Token::Id)
+      return fail(QStringLiteral("expected a statement"));
+
+    QString const name = _lexer.text();
+    advance();
+
+    // graph attribute
+    if (_token == Token::Equals)
+    {
+      advance();
+      return expect(Token::Id, "a value");
+    }
+
+    std::vector<Endpoint> endpoints;
+    endpoints.push_back(Endpoint{name, port()});
+
+    bool complete = true;
+
+    while (_token == Token::EdgeOp)
+    {
+      advance();
+
+      if (isKeyword("subgraph") || _token == Token::LeftBrace)
+      {
+        // edges to whole subgraphs are not supported, the nodes are kept
+        if (!subgraph())
+          return false;
+
+        complete = false;
+        continue;
+      }
+
+      if (_token != Token::Id)
+        return fail(QStringLiteral("expected a node"));
+
+      QString const next = _lexer.text();
+      advance();
+
+      endpoints.push_back(Endpoint{next, port()});
+    }
+
+    QJsonObject attributes;
+    if (!attributeLists(attributes))
+      return false;
+
+    if (endpoints.size() == 1 && complete)
+    {
+      QJsonObject nodeAttributes = _nodeDefaults;
+      for (auto iter = attributes.begin(); iter != attributes.end(); ++iter)
+        nodeAttributes[iter.key()] = iter.value();
+
+      QPointF position;
+      bool const positioned = takePosition(nodeAttributes, position);
+
+      _sink.node(name, nodeAttributes, positioned ? &position : nullptr);
+      return true;
+    }
+
+    for (auto const& endpoint : endpoints)
+      _sink.mention(endpoint.name, _nodeDefaults);
+
+    for (std::size_t i = 1; i < endpoints.size(); ++i)
+    {
+      _sink.edge(endpoints[i - 1].name, endpoints[i - 1].port,
+                 endpoints[i].name, endpoints[i].port);
+    }
+
+    return true;
+  }
+
+  /// `:port` and `:port:compass`, the compass point is ignored
+  PortIndex
+  port()
+  {
+    if (_token != Token::Colon)
+      return 0;
+
+    advance();
+
+    if (_token != Token::Id)
+      return 0;
+
+    PortIndex const index = portIndex(_lexer.text());
+    advance();
+
+    if (_token == Token::Colon)
+    {
+      advance();
+      if (_token == Token::Id)
+        advance();
+    }
+
+    return index;
+  }
+
+  bool
+  subgraph()
+  {
+    if (isKeyword("subgraph"))
+    {
+      advance();
+
+      if (_token == Token::Id)
+        advance();
+    }
+
+    return block();
+  }
+
+  /// Any number of `[ a = b, ... ]`
+  bool
+  attributeLists(QJsonObject& attributes)
+  {
+    while (_token == Token::LeftBracket)
+    {
+      advance();
+
+      while (_token == Token::Id)
+      {
+        QString const key = _lexer.text();
+        advance();
+
+        if (!expect(Token::Equals, "'='"))
+          return false;
+
+        if (_token != Token::Id)
+          return fail(QStringLiteral("expected a value"));
+
+        attributes[key] = _lexer.text();
+        advance();
+
+        if (_token == Token::Comma || _token == Token::Semicolon)
+          advance();
+      }
+
+      if (!expect(Token::RightBracket, "']'"))
+        return false;
+    }
+
+    return true;
+  }
+
+  /// Removes "pos" from `attributes`, Graphviz's y axis points up
+  static bool
+  takePosition(QJsonObject& attributes, QPointF& position)
+  {
+    QString pos = attributes.take(QStringLiteral("pos")).toString();
+
+    if (pos.isEmpty())
+      return false;
+
+    pos.remove(QLatin1Char('!'));
+
+    QStringList const coordinates = pos.split(QLatin1Char(','));
+    if (coordinates.size() < 2)
+      return false;
+
+    position = QPointF(coordinates[0].toDouble(), -coordinates[1].toDouble());
+    return true;
+  }
+
+private:
+
+  DotLexer    _lexer;
+  ImportSink& _sink;
+
+  Token _token = Token::End;
+
+  QJsonObject _nodeDefaults;
+
+  QString _error;
+};
+
+}
+
+GraphImporter::
+GraphImporter(DataFlowScene& scene)
+  : _scene(scene)
+{}
+
+
+void
+GraphImporter::
+setTypeMapping(QString const& externalType, QString const& modelName)
+{
+  _typeMapping[externalType] = modelName;
+}
+
+
+bool
+GraphImporter::
+importFile(QString const& fileName)
+{
+  reset();
+
+  QFile file(fileName);
+
+  if (!file.open(QIODevice::ReadOnly))
+  {
+    _errorString = file.errorString();
+    return false;
+  }
+
+  QString const suffix = QFileInfo(fileName).suffix().toLower();
+
+  if (suffix == "graphml")
+    return importGraphML(file);
+
+  if (suffix == "dot" || suffix == "gv")
+    return importDot(file);
+
+  _errorString = QStringLiteral("Unknown graph format: %1").arg(suffix);
+  return false;
+}
+
+
+bool
+GraphImporter::
+importGraphML(QIODevice& device)
+{
+  reset();
+
+  auto* model = static_cast<DataFlowModel*>(_scene.model());
+
+  model->beginBulkLoad();
+
+  ImportSink sink(*this, *model);
+
+  QXmlStreamReader xml(&device);
+
+  // declared <key>s: id to attribute name, and defaults of node attributes
+  std::unordered_map<QString, QString> keyNames;
+  QJsonObject                          nodeDefaults;
+
+  enum class Element { None, Node, Edge };
+
+  Element     element = Element::None;
+  QString     name, source, target;
+  PortIndex   sourcePort = 0, targetPort = 0;
+  QJsonObject attributes;
+
+  auto emitNode = [&]() {
+    QPointF position;
+    bool const positioned = attributes.contains("x") && attributes.contains("y");
+
+    if (positioned)
+      position = QPointF(attributes.take("x").toString().toDouble(),
+                         attributes.take("y").toString().toDouble());
+
+    sink.node(name, attributes, positioned ? &position : nullptr);
+    element = Element::None;
+  };
+
+  while (!xml.atEnd())
+  {
+    xml.readNext();
+
+    if (xml.isStartElement())
+    {
+      auto const tag = xml.name();
+
+      if (tag == QLatin1String("key"))
+      {
+        QString const id       = xml.attributes().value("id").toString();
+        QString const attrName = xml.attributes().value("attr.name").toString();
+        QString const domain   = xml.attributes().value("for").toString();
+
+        keyNames[id] = attrName.isEmpty() ? id : attrName;
+
+        // only <default> matters inside a key
+        while (xml.readNextStartElement())
+        {
+          if (xml.name() == QLatin1String("default") &&
+              (domain == QLatin1String("node") || domain == QLatin1String("all")))
+            nodeDefaults[keyNames[id]] = xml.readElementText(QXmlStreamReader::SkipChildElements);
+          else
+            xml.skipCurrentElement();
+        }
+      }
+      else if (tag == QLatin1String("node"))
+      {
+        // a nested graph of the previous node began without closing it
+        if (element == Element::Node)
+          emitNode();
+
+        element    = Element::Node;
+        name       = xml.attributes().value("id").toString();
+        attributes = nodeDefaults;
+      }
+      else if (tag == QLatin1String("edge"))
+      {
+        element    = Element::Edge;
+        source     = xml.attributes().value("source").toString();
+        target     = xml.attributes().value("target").toString();
+        sourcePort = portIndex(xml.attributes().value("sourceport").toString());
+        targetPort = portIndex(xml.attributes().value("targetport").toString());
+        attributes = QJsonObject();
+      }
+      else if (tag == QLatin1String("graph") && element == Element::Node)
+      {
+        emitNode();
+      }
+      else if (tag == QLatin1String("data") && element != Element::None)
+      {
+        QString const key = xml.attributes().value("key").toString();
+
+        auto keyName = keyNames.find(key);
+        QString const attribute = keyName != keyNames.end() ? keyName->second : key;
+
+        attributes[attribute] = xml.readElementText(QXmlStreamReader::SkipChildElements);
+      }
+    }
+    else if (xml.isEndElement())
+    {
+      if (xml.name() == QLatin1String("node") && element == Element::Node)
+      {
+        emitNode();
+      }
+      else if (xml.name() == QLatin1String("edge") && element == Element::Edge)
+      {
+        if (attributes.contains("sourceport"))
+          sourcePort = portIndex(attributes["sourceport"].toString());
+
+        if (attributes.contains("targetport"))
+          targetPort = portIndex(attributes["targetport"].toString());
+
+        sink.edge(source, sourcePort, target, targetPort);
+        element = Element::None;
+      }
+    }
+  }
+
+  sink.finish();
+
+  model->endBulkLoad();
+
+  if (xml.hasError())
+  {
+    _errorString = QStringLiteral("line %1: %2").arg(xml.lineNumber()).arg(xml.errorString());
+    return false;
+  }
+
+  return true;
+}
+
+
+bool
+GraphImporter::
+importDot(QIODevice& device)
+{
+  reset();
+
+  auto* model = static_cast<DataFlowModel*>(_scene.model());
+
+  model->beginBulkLoad();
+
+  ImportSink sink(*this, *model);
+  DotParser  parser(device, sink);
+
+  bool const parsed = parser.parse();
+
+  sink.finish();
+
+  model->endBulkLoad();
+
+  if (!parsed)
+    _errorString = parser.errorString();
+
+  return parsed;
+}
+
+
+QString
+GraphImporter::
+modelFor(QString const& type) const
+{
+  auto mapped = _typeMapping.find(type);
+  if (mapped != _typeMapping.end())
+    return mapped->second;
+
+  if (!type.isEmpty() && _scene.registry().registeredModelCreators().count(type) != 0)
+    return type;
+
+  return _defaultModel;
+}
+
+
+void
+GraphImporter::
+reset()
+{
+  _errorString.clear();
+
+  _nodesImported       = 0;
+  _connectionsImported = 0;
+  _skipped             = 0;
+}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <QtCore/QString>
+
+#include "Export.hpp"
+#include "QStringStdHash.hpp"
+
+class QIODevice;
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+
+/// Imports graphs written by other tools, GraphML or Graphviz DOT, into a
+/// DataFlowScene.
+///
+/// Files are read incrementally, GraphML with QXmlStreamReader and DOT with
+/// a tokenizer over a small buffer, and each node and edge goes straight to
+/// the model inside one bulk load; no document tree is built. Edges naming
+/// a node not seen yet wait until it is, or until the end where it is
+/// created with the default model.
+///
+/// A node's model is picked from its type attribute (`typeAttribute()`,
+/// "type" by default): through `setTypeMapping`, else a registered model of
+/// that name, else `defaultModel()`. Nodes without a model are skipped
+/// along with their edges. The other attributes are handed to the model's
+/// `restore()` as strings, except positions: "x" and "y" in GraphML, "pos"
+/// in DOT (y flipped, Graphviz points up). Ports are indices: "sourceport"
+/// and "targetport" in GraphML, `node:port` in DOT, 0 when missing. Edges
+/// between ports that don't exist, are taken already or carry types no
+/// converter models bridge are skipped; convertible ones get the
+/// converters in between.
+class NODE_EDITOR_PUBLIC GraphImporter
+{
+public:
+
+  explicit
+  GraphImporter(DataFlowScene& scene);
+
+  void
+  setTypeMapping(QString const& externalType, QString const& modelName);
+
+  QString
+  typeAttribute() const { return _typeAttribute; }
+
+  void
+  setTypeAttribute(QString const& name) { _typeAttribute = name; }
+
+  QString
+  defaultModel() const { return _defaultModel; }
+
+  /// Model of nodes without a known type, none by default
+  void
+  setDefaultModel(QString const& modelName) { _defaultModel = modelName; }
+
+  /// Picks the format from the suffix: .graphml, or .dot and .gv
+  bool
+  importFile(QString const& fileName);
+
+  bool
+  importGraphML(QIODevice& device);
+
+  bool
+  importDot(QIODevice& device);
+
+  QString
+  errorString() const { return _errorString; }
+
+  /// Counts of the last import
+  std::size_t
+  nodesImported() const { return _nodesImported; }
+
+  std::size_t
+  connectionsImported() const { return _connectionsImported; }
+
+  /// Nodes without a model, and edges that could not be connected or were
+  /// rejected
+  std::size_t
+  skipped() const { return _skipped; }
+
+private:
+
+  friend class ImportSink;
+
+  QString
+  modelFor(QString const& type) const;
+
+  void
+  reset();
+
+private:
+
+  DataFlowScene& _scene;
+
+  std::unordered_map<QString, QString> _typeMapping;
+
+  QString _typeAttribute = QStringLiteral("type");
+  QString _defaultModel;
+
+  QString _errorString;
+
+  std::size_t _nodesImported       = 0;
+  std::size_t _connectionsImported = 0;
+  std::size_t _skipped             = 0;
+};
+}
@@ -0,0 +1,214 @@
+#include "GraphIndex.hpp"
+
+#include <algorithm>
+
+#include "NodeDataModel.hpp"
+
+namespace QtNodes {
+
+NodeSignature
+NodeSignature::
+of(NodeDataModel const& model)
+{
+  NodeSignature signature;
+  signature.modelName = model.name();
+
+  for (PortIndex i = 0; (unsigned)i < model.nPorts(PortType::In); ++i) {
+    signature.inTypes.push_back(model.dataType(PortType::In, i).id);
+  }
+
+  for (PortIndex i = 0; (unsigned)i < model.nPorts(PortType::Out); ++i) {
+    signature.outTypes.push_back(model.dataType(PortType::Out, i).id);
+  }
+
+  return signature;
+}
+
+
+GraphIndex::NodeSet const&
+GraphIndex::
+nodesOfModel(QString const& modelName) const
+{
+  static NodeSet const empty;
+
+  auto iter = _nodesByModel.find(modelName);
+
+  return iter == _nodesByModel.end() ? empty : iter->second;
+}
+
+
+GraphIndex::PortSet const&
+GraphIndex::
+portsOfDataType(QString const& dataTypeId) const
+{
+  static PortSet const empty;
+
+  auto iter = _portsByDataType.find(dataTypeId);
+
+  return iter == _portsByDataType.end() ? empty : iter->second;
+}
+
+
+std::size_t
+GraphIndex::
+fanOut(QUuid const& nodeId) const
+{
+  auto iter = _fanOut.find(nodeId);
+
+  return iter == _fanOut.end() ? 0 : iter->second;
+}
+
+
+std::vector<std::pair<QUuid, std::size_t>>
+GraphIndex::
+largestFanOut(std::size_t count) const
+{
+  std::vector<std::pair<QUuid, std::size_t>> ret;
+  ret.reserve(std::min(count, _fanOutOrder.size()));
+
+  for (auto iter = _fanOutOrder.rbegin();
+       iter != _fanOutOrder.rend() && ret.size() < count;
+       ++iter)
+  {
+    ret.emplace_back(iter->second, iter->first);
+  }
+
+  return ret;
+}
+
+
+void
+GraphIndex::
+nodeAdded(QUuid const& id, NodeSignature const& signature)
+{
+  ++_nodeCount;
+
+  _nodesByModel[signature.modelName].insert(id);
+
+  auto addPorts = [&](PortType portType) {
+    auto const& types = signature.types(portType);
+
+    for (PortIndex i = 0; (std::size_t)i < types.size(); ++i) {
+      PortAddress address{id, portType, i};
+
+      _portsByDataType[types[i]].insert(address);
+
+      if (portType == PortType::In) {
+        _unconnectedInputs.insert(address);
+      }
+    }
+  };
+  addPorts(PortType::In);
+  addPorts(PortType::Out);
+}
+
+
+void
+GraphIndex::
+nodeRemoved(QUuid const& id, NodeSignature const& signature)
+{
+  --_nodeCount;
+
+  auto byModel = _nodesByModel.find(signature.modelName);
+  if (byModel != _nodesByModel.end()) {
+    byModel->second.erase(id);
+
+    if (byModel->second.empty()) {
+      _nodesByModel.erase(byModel);
+    }
+  }
+
+  auto removePorts = [&](PortType portType) {
+    auto const& types = signature.types(portType);
+
+    for (PortIndex i = 0; (std::size_t)i < types.size(); ++i) {
+      PortAddress address{id, portType, i};
+
+      auto byType = _portsByDataType.find(types[i]);
+      if (byType != _portsByDataType.end()) {
+        byType->second.erase(address);
+
+        if (byType->second.empty()) {
+          _portsByDataType.erase(byType);
+        }
+      }
+
+      if (portType == PortType::In) {
+        _unconnectedInputs.erase(address);
+        _inputConnections.erase(address);
+      }
+    }
+  };
+  removePorts(PortType::In);
+  removePorts(PortType::Out);
+
+  setFanOut(id, 0);
+}
+
+
+void
+GraphIndex::
+connectionAdded(ConnectionID const& id)
+{
+  ++_connectionCount;
+
+  PortAddress input{id.rNodeID, PortType::In, id.rPortID};
+
+  if (++_inputConnections[input] == 1) {
+    _unconnectedInputs.erase(input);
+  }
+
+  setFanOut(id.lNodeID, fanOut(id.lNodeID) + 1);
+}
+
+
+void
+GraphIndex::
+connectionRemoved(ConnectionID const& id)
+{
+  --_connectionCount;
+
+  PortAddress input{id.rNodeID, PortType::In, id.rPortID};
+
+  auto iter = _inputConnections.find(input);
+  Q_ASSERT(iter != _inputConnections.end());
+
+  if (--iter->second == 0) {
+    _inputConnections.erase(iter);
+    _unconnectedInputs.insert(input);
+  }
+
+  auto const current = fanOut(id.lNodeID);
+  Q_ASSERT(current > 0);
+
+  setFanOut(id.lNodeID, current - 1);
+}
+
+
+void
+GraphIndex::
+setFanOut(QUuid const& nodeId, std::size_t fanOut)
+{
+  auto iter = _fanOut.find(nodeId);
+
+  if (iter != _fanOut.end()) {
+    _fanOutOrder.erase(std::make_pair(iter->second, nodeId));
+
+    if (fanOut == 0) {
+      _fanOut.erase(iter);
+      return;
+    }
+
+    iter->second = fanOut;
+  } else {
+    if (fanOut == 0) {
+      return;
+    }
+
+    _fanOut.emplace(nodeId, fanOut);
+  }
+
+  _fanOutOrder.emplace(fanOut, nodeId);
+}
+
+} // namespace QtNodes
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <set>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QtCore/QUuid>
+#include <QtCore/QString>
+
+#include "Export.hpp"
+#include "PortType.hpp"
+#include "ConnectionID.hpp"
+#include "QUuidStdHash.hpp"
+#include "QStringStdHash.hpp"
+
+namespace QtNodes
+{
+
+class NodeDataModel;
+
+struct PortAddress
+{
+  QUuid     nodeId;
+  PortType  portType;
+  PortIndex portIndex;
+};
+
+/// What the index keeps of a node's model: its name and the data type id
+/// of every port. Read from the model before the graph lock is taken.
+struct NODE_EDITOR_PUBLIC NodeSignature
+{
+  QString              modelName;
+  std::vector<QString> inTypes;
+  std::vector<QString> outTypes;
+
+  static
+  NodeSignature
+  of(NodeDataModel const& model);
+
+  std::vector<QString> const&
+  types(PortType portType) const { return portType == PortType::In ? inTypes : outTypes; }
+};
+
+inline bool operator==(PortAddress const& lhs, PortAddress const& rhs) {
+  return lhs.nodeId    == rhs.nodeId &&
+         lhs.portType  == rhs.portType &&
+         lhs.portIndex == rhs.portIndex;
+}
+
+} // namespace QtNodes
+
+namespace std {
+
+template<>
+struct hash<::QtNodes::PortAddress> {
+  size_t operator()(::QtNodes::PortAddress const& toHash) const {
+    return qHash(toHash.nodeId) ^ (std::hash<int>()(static_cast<int>(toHash.portType)) << 1) ^ (std::hash<QtNodes::PortIndex>()(toHash.portIndex) << 3);
+  }
+};
+
+} // namespace std
+
+namespace QtNodes
+{
+
+/// Secondary indexes and counters over a DataFlowModel's graph.
+///
+/// Kept up to date incrementally by the model on every mutation, so all
+/// queries are lookups rather than scans. Reading from another thread
+/// requires holding `DataFlowModel::graphLock()` for reading.
+class NODE_EDITOR_PUBLIC GraphIndex
+{
+public:
+
+  using NodeSet = std::unordered_set<QUuid>;
+  using PortSet = std::unordered_set<PortAddress>;
+
+public:
+
+  std::size_t
+  nodeCount() const { return _nodeCount; }
+
+  std::size_t
+  connectionCount() const { return _connectionCount; }
+
+  /// Ids of all nodes whose model has the given `NodeDataModel::name()`
+  NodeSet const&
+  nodesOfModel(QString const& modelName) const;
+
+  /// All in and out ports carrying the given `NodeDataType::id`
+  PortSet const&
+  portsOfDataType(QString const& dataTypeId) const;
+
+  /// Input ports with no connection
+  PortSet const&
+  unconnectedInputs() const { return _unconnectedInputs; }
+
+  /// Number of connections leaving the node, over all its out ports
+  std::size_t
+  fanOut(QUuid const& nodeId) const;
+
+  /// Up to `count` nodes with the most outgoing connections, largest first
+  std::vector<std::pair<QUuid, std::size_t>>
+  largestFanOut(std::size_t count) const;
+
+public: // maintenance, called by the model
+
+  void
+  nodeAdded(QUuid const& id, NodeSignature const& signature);
+
+  void
+  nodeRemoved(QUuid const& id, NodeSignature const& signature);
+
+  void
+  connectionAdded(ConnectionID const& id);
+
+  void
+  connectionRemoved(ConnectionID const& id);
+
+private:
+
+  void
+  setFanOut(QUuid const& nodeId, std::size_t fanOut);
+
+private:
+
+  std::size_t _nodeCount       = 0;
+  std::size_t _connectionCount = 0;
+
+  std::unordered_map<QString, NodeSet> _nodesByModel;
+  std::unordered_map<QString, PortSet> _portsByDataType;
+
+  PortSet _unconnectedInputs;
+
+  // connections per connected input port
+  std::unordered_map<PortAddress, std::size_t> _inputConnections;
+
+  std::unordered_map<QUuid, std::size_t> _fanOut;
+
+  // (fan-out, node) for nodes with at least one outgoing connection
+  std::set<std::pair<std::size_t, QUuid>> _fanOutOrder;
+};
+
+} // namespace QtNodes
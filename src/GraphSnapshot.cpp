@@ -0,0 +1,111 @@
+#include "GraphSnapshot.hpp"
+
+#include <QtCore/QJsonArray>
+
+namespace QtNodes {
+
+GraphSnapshot::
+GraphSnapshot(NodeMap nodes,
+              ConnectionMap connections,
+              std::size_t version)
+  : _nodes(std::move(nodes))
+  , _connections(std::move(connections))
+  , _version(version)
+{}
+
+
+NodeRecord const*
+GraphSnapshot::
+node(QUuid const& id) const
+{
+  auto record = _nodes.find(id);
+
+  return record ? record->get() : nullptr;
+}
+
+
+QJsonObject
+GraphSnapshot::
+toJson() const
+{
+  QJsonObject sceneJson;
+
+  QJsonArray nodesJsonArray;
+
+  _nodes.forEach([&](QUuid const&, NodeRecordPtr const& record)
+  {
+    QJsonObject nodeJson;
+
+    nodeJson["id"]    = record->id.toString();
+    nodeJson["model"] = record->modelState;
+
+    QJsonObject obj;
+    obj["x"] = record->position.x();
+    obj["y"] = record->position.y();
+    nodeJson["position"] = obj;
+
+    nodesJsonArray.append(nodeJson);
+  });
+
+  sceneJson["nodes"] = nodesJsonArray;
+
+  QJsonArray connectionJsonArray;
+
+  _connections.forEach([&](ConnectionID const& id, NodeDataType const&)
+  {
+    QJsonObject connectionJson;
+
+    connectionJson["in_id"]     = id.rNodeID.toString();
+    connectionJson["in_index"]  = id.rPortID;
+    connectionJson["out_id"]    = id.lNodeID.toString();
+    connectionJson["out_index"] = id.lPortID;
+
+    connectionJsonArray.append(connectionJson);
+  });
+
+  sceneJson["connections"] = connectionJsonArray;
+
+  return sceneJson;
+}
+
+
+GraphSnapshot
+GraphSnapshot::
+fromJson(QJsonObject const& scene)
+{
+  NodeMap       nodes;
+  ConnectionMap connections;
+
+  for (QJsonValue const& value : scene["nodes"].toArray())
+  {
+    QJsonObject const nodeJson = value.toObject();
+
+    auto record = std::make_shared<NodeRecord>();
+    record->id         = QUuid(nodeJson["id"].toString());
+    record->modelState = nodeJson["model"].toObject();
+    record->modelName  = record->modelState.value("name").toString();
+
+    QJsonObject const position = nodeJson["position"].toObject();
+    record->position = QPointF(position["x"].toDouble(), position["y"].toDouble());
+
+    QUuid const id = record->id;
+    nodes = nodes.insert(id, std::move(record));
+  }
+
+  for (QJsonValue const& value : scene["connections"].toArray())
+  {
+    QJsonObject const connectionJson = value.toObject();
+
+    ConnectionID id;
+    id.lNodeID = QUuid(connectionJson["out_id"].toString());
+    id.lPortID = connectionJson["out_index"].toInt();
+    id.rNodeID = QUuid(connectionJson["in_id"].toString());
+    id.rPortID = connectionJson["in_index"].toInt();
+
+    connections = connections.insert(id, NodeDataType());
+  }
+
+  return GraphSnapshot(std::move(nodes), std::move(connections), 0);
+}
+
+} // namespace QtNodes
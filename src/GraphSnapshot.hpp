@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+
+#include <QtCore/QUuid>
+#include <QtCore/QString>
+#include <QtCore/QPointF>
+#include <QtCore/QJsonObject>
+
+#include "Export.hpp"
+#include "NodeData.hpp"
+#include "ConnectionID.hpp"
+#include "PersistentMap.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+/// State of one node as recorded in a GraphSnapshot
+struct NodeRecord
+{
+  QUuid id;
+
+  /// `NodeDataModel::name()` of the node's model
+  QString modelName;
+
+  QPointF position;
+
+  /// Last `NodeDataModel::save()` recorded for the node
+  QJsonObject modelState;
+};
+
+/// Immutable, consistent view of a DataFlowModel's graph.
+///
+/// Snapshots are obtained in O(1) from `DataFlowModel::snapshot()` and share
+/// every unchanged record with the live graph and with each other, so keeping
+/// many versions around only costs the changes between them. They can be
+/// read from any thread.
+class NODE_EDITOR_PUBLIC GraphSnapshot
+{
+public:
+
+  using NodeRecordPtr = std::shared_ptr<NodeRecord const>;
+  using NodeMap       = PersistentMap<QUuid, NodeRecordPtr>;
+
+  /// Connections map to the data type they carry
+  using ConnectionMap = PersistentMap<ConnectionID, NodeDataType>;
+
+  GraphSnapshot() = default;
+
+  GraphSnapshot(NodeMap nodes,
+                ConnectionMap connections,
+                std::size_t version);
+
+public:
+
+  NodeMap const&
+  nodes() const { return _nodes; }
+
+  ConnectionMap const&
+  connections() const { return _connections; }
+
+  /// Grows by at least one with every change of the graph
+  std::size_t
+  version() const { return _version; }
+
+  /// Returns nullptr if there is no such node
+  NodeRecord const*
+  node(QUuid const& id) const;
+
+  /// Same layout as `DataFlowScene::saveToMemory`
+  QJsonObject
+  toJson() const;
+
+  /// Reads a scene saved in that layout, e.g. to compare saved files with
+  /// SceneDiff. Connections carry no data type.
+  static GraphSnapshot
+  fromJson(QJsonObject const& scene);
+
+private:
+
+  NodeMap       _nodes;
+  ConnectionMap _connections;
+  std::size_t   _version = 0;
+};
+
+} // namespace QtNodes
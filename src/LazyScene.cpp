@@ -0,0 +1,510 @@
+#include "LazyScene.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include <QtCore/QDebug>
+#include <QtWidgets/QGraphicsView>
+#include <QtWidgets/QScrollBar>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "BinaryScene.hpp"
+
+namespace QtNodes {
+
+namespace
+{
+// side of a spatial grid cell, in scene units
+constexpr qreal CellSize = 512.0;
+}
+
+constexpr LazyScene::Record LazyScene::NoRecord;
+
+LazyScene::
+LazyScene(DataFlowScene& scene, QObject* parent)
+  : QObject(parent)
+  , _scene(scene)
+{}
+
+
+LazyScene::
+~LazyScene()
+{
+  unfollow();
+  close();
+}
+
+
+bool
+LazyScene::
+open(QString const& fileName)
+{
+  close();
+
+  _file.setFileName(fileName);
+
+  if (!_file.open(QIODevice::ReadOnly))
+  {
+    _errorString = _file.errorString();
+    return false;
+  }
+
+  _mapped = _file.map(0, _file.size());
+
+  if (!_mapped)
+  {
+    _errorString = _file.errorString();
+    close();
+    return false;
+  }
+
+  _reader = std::make_unique<BinarySceneReader>(reinterpret_cast<char const*>(_mapped),
+                                                std::size_t(_file.size()));
+
+  if (!_reader->isValid())
+  {
+    _errorString = tr("Invalid binary scene");
+    close();
+    return false;
+  }
+
+  _errorString.clear();
+
+  _materialized.assign(_reader->nodeCount(), false);
+
+  return true;
+}
+
+
+void
+LazyScene::
+close()
+{
+  _reader.reset();
+
+  if (_mapped)
+  {
+    _file.unmap(_mapped);
+    _mapped = nullptr;
+  }
+
+  _file.close();
+
+  _materialized.clear();
+  _materializedCount = 0;
+
+  _ids.clear();
+  _grid.clear();
+  _gridBuilt = false;
+  _upstream.clear();
+  _downstream.clear();
+  _linksBuilt = false;
+}
+
+
+std::size_t
+LazyScene::
+nodeCount() const
+{
+  return _reader ? _reader->nodeCount() : 0;
+}
+
+
+bool
+LazyScene::
+contains(QUuid const& id)
+{
+  return record(id) != NoRecord;
+}
+
+
+bool
+LazyScene::
+isMaterialized(QUuid const& id)
+{
+  Record const r = record(id);
+
+  return r != NoRecord && _materialized[r];
+}
+
+
+QPointF
+LazyScene::
+nodePosition(QUuid const& id)
+{
+  Record const r = record(id);
+
+  if (r == NoRecord)
+    return QPointF();
+
+  return _reader->node(r).position;
+}
+
+
+std::vector<QUuid>
+LazyScene::
+nodesIn(QRectF const& rect)
+{
+  std::vector<QUuid> result;
+
+  if (!_reader)
+    return result;
+
+  buildGrid();
+
+  int const left   = int(std::floor(rect.left() / CellSize));
+  int const right  = int(std::floor(rect.right() / CellSize));
+  int const top    = int(std::floor(rect.top() / CellSize));
+  int const bottom = int(std::floor(rect.bottom() / CellSize));
+
+  // a huge rect visits the occupied cells rather than every cell in it
+  bool const scanAll = qint64(right - left + 1) * qint64(bottom - top + 1) > qint64(_grid.size());
+
+  auto collect = [&](std::vector<Record> const& records) {
+    for (Record r : records)
+    {
+      auto const entry = _reader->node(r);
+
+      if (rect.contains(entry.position))
+        result.push_back(entry.id);
+    }
+  };
+
+  if (scanAll)
+  {
+    for (auto const& cell : _grid)
+      collect(cell.second);
+  }
+  else
+  {
+    for (int y = top; y <= bottom; ++y)
+    {
+      for (int x = left; x <= right; ++x)
+      {
+        auto iter = _grid.find(cellKey(x, y));
+
+        if (iter != _grid.end())
+          collect(iter->second);
+      }
+    }
+  }
+
+  return result;
+}
+
+
+bool
+LazyScene::
+materialize(QUuid const& id)
+{
+  Record const r = record(id);
+
+  if (r == NoRecord)
+    return false;
+
+  materializeRecords({r});
+
+  return true;
+}
+
+
+void
+LazyScene::
+materializeRegion(QRectF const& rect)
+{
+  std::vector<Record> records;
+
+  for (QUuid const& id : nodesIn(rect))
+  {
+    Record const r = _ids[id];
+
+    if (!_materialized[r])
+      records.push_back(r);
+  }
+
+  materializeRecords(std::move(records));
+}
+
+
+void
+LazyScene::
+materializeAll()
+{
+  std::vector<Record> records;
+
+  for (std::size_t r = 0; r < _materialized.size(); ++r)
+  {
+    if (!_materialized[r])
+      records.push_back(Record(r));
+  }
+
+  materializeRecords(std::move(records));
+}
+
+
+void
+LazyScene::
+follow(QGraphicsView* view)
+{
+  unfollow();
+
+  _view = view;
+
+  if (!_view)
+    return;
+
+  // zooming changes the scroll bar ranges, panning their values
+  for (QScrollBar* bar : {_view->horizontalScrollBar(), _view->verticalScrollBar()})
+  {
+    _viewConnections.push_back(connect(bar, &QScrollBar::valueChanged,
+                                       this, &LazyScene::materializeVisible));
+    _viewConnections.push_back(connect(bar, &QScrollBar::rangeChanged,
+                                       this, &LazyScene::materializeVisible));
+  }
+
+  _viewConnections.push_back(connect(_view, &QObject::destroyed,
+                                     this, &LazyScene::unfollow));
+
+  materializeVisible();
+}
+
+
+void
+LazyScene::
+unfollow()
+{
+  for (auto const& connection : _viewConnections)
+    disconnect(connection);
+
+  _viewConnections.clear();
+  _view = nullptr;
+}
+
+
+LazyScene::Record
+LazyScene::
+record(QUuid const& id)
+{
+  if (!_reader)
+    return NoRecord;
+
+  buildIdIndex();
+
+  auto iter = _ids.find(id);
+
+  return iter == _ids.end() ? NoRecord : iter->second;
+}
+
+
+void
+LazyScene::
+buildIdIndex()
+{
+  if (!_ids.empty() || _reader->nodeCount() == 0)
+    return;
+
+  _ids.reserve(_reader->nodeCount());
+
+  for (std::size_t r = 0; r < _reader->nodeCount(); ++r)
+    _ids.emplace(_reader->node(r).id, Record(r));
+}
+
+
+void
+LazyScene::
+buildGrid()
+{
+  if (_gridBuilt)
+    return;
+
+  for (std::size_t r = 0; r < _reader->nodeCount(); ++r)
+  {
+    QPointF const position = _reader->node(r).position;
+
+    _grid[cellKey(int(std::floor(position.x() / CellSize)),
+                  int(std::floor(position.y() / CellSize)))].push_back(Record(r));
+  }
+
+  _gridBuilt = true;
+}
+
+
+bool
+LazyScene::
+buildLinks()
+{
+  if (_linksBuilt)
+    return true;
+
+  std::vector<BinarySceneReader::ConnectionEntry> connections;
+
+  if (!_reader->connections(connections))
+    return false;
+
+  buildIdIndex();
+
+  _upstream.assign(_reader->nodeCount(), {});
+  _downstream.assign(_reader->nodeCount(), {});
+
+  auto find = [&](QUuid const& id) {
+    auto iter = _ids.find(id);
+    return iter == _ids.end() ? NoRecord : iter->second;
+  };
+
+  for (auto const& connection : connections)
+  {
+    Record const out = find(connection.outNode);
+    Record const in  = find(connection.inNode);
+
+    if (in != NoRecord)
+    {
+      _upstream[in].push_back(Link{out, out == NoRecord ? connection.outNode : QUuid(),
+                                   connection.inPort, connection.outPort});
+    }
+
+    if (out != NoRecord)
+    {
+      _downstream[out].push_back(Link{in, in == NoRecord ? connection.inNode : QUuid(),
+                                      connection.outPort, connection.inPort});
+    }
+  }
+
+  _linksBuilt = true;
+
+  return true;
+}
+
+
+void
+LazyScene::
+materializeRecords(std::vector<Record> records)
+{
+  if (!_reader || records.empty())
+    return;
+
+  if (!buildLinks())
+  {
+    qWarning() << "Malformed connection table in" << _file.fileName();
+    return;
+  }
+
+  // the views get the nodes and their connections at once, evaluated
+  auto& dataFlowModel = *static_cast<DataFlowModel*>(_scene.model());
+  dataFlowModel.beginBulkLoad();
+
+  // create the nodes and everything upstream of them
+
+  std::vector<Record> created;
+
+  while (!records.empty())
+  {
+    Record const r = records.back();
+    records.pop_back();
+
+    if (_materialized[r])
+      continue;
+
+    _materialized[r] = true;
+    ++_materializedCount;
+
+    auto const entry = _reader->node(r);
+
+    // already in the scene, e.g. loaded some other way
+    if (_scene.model()->nodeIndex(entry.id).isValid())
+      continue;
+
+    try
+    {
+      _scene.restoreNode(entry.id, entry.modelName, entry.position, _reader->modelState(entry));
+    }
+    catch (std::logic_error const& error)
+    {
+      qWarning() << "Couldn't materialize node" << entry.id << ":" << error.what();
+      continue;
+    }
+
+    created.push_back(r);
+
+    for (Link const& link : _upstream[r])
+    {
+      if (link.node != NoRecord && !_materialized[link.node])
+        records.push_back(link.node);
+    }
+  }
+
+  if (created.empty())
+  {
+    dataFlowModel.endBulkLoad();
+    return;
+  }
+
+  // connect them, each connection once: inputs of every created node, and
+  // outputs to nodes materialized before
+
+  std::vector<Record> sortedCreated = created;
+  std::sort(sortedCreated.begin(), sortedCreated.end());
+
+  auto model = _scene.model();
+
+  auto nodeIndex = [&](Link const& link) {
+    return model->nodeIndex(link.node == NoRecord ? link.external
+                                                  : _reader->node(link.node).id);
+  };
+
+  for (Record r : created)
+  {
+    NodeIndex const self = model->nodeIndex(_reader->node(r).id);
+
+    for (Link const& link : _upstream[r])
+    {
+      NodeIndex const other = nodeIndex(link);
+
+      if (other.isValid())
+        model->addConnection(other, link.otherPort, self, link.ownPort);
+    }
+
+    for (Link const& link : _downstream[r])
+    {
+      if (link.node != NoRecord &&
+          std::binary_search(sortedCreated.begin(), sortedCreated.end(), link.node))
+        continue;
+
+      NodeIndex const other = nodeIndex(link);
+
+      if (other.isValid())
+        model->addConnection(self, link.ownPort, other, link.otherPort);
+    }
+  }
+
+  dataFlowModel.endBulkLoad();
+
+  emit nodesMaterialized(created.size());
+}
+
+
+void
+LazyScene::
+materializeVisible()
+{
+  if (!_view || !_reader)
+    return;
+
+  QRectF visible = _view->mapToScene(_view->viewport()->rect()).boundingRect();
+
+  // a margin of half a screen so that nodes are there before they scroll in
+  visible.adjust(-visible.width() / 2, -visible.height() / 2,
+                 visible.width() / 2, visible.height() / 2);
+
+  materializeRegion(visible);
+}
+
+
+std::uint64_t
+LazyScene::
+cellKey(int x, int y)
+{
+  return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y);
+}
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include <QtCore/QObject>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+#include <QtCore/QRectF>
+#include <QtCore/QPointF>
+#include <QtCore/QMetaObject>
+
+#include "Export.hpp"
+#include "PortType.hpp"
+#include "QUuidStdHash.hpp"
+
+class QGraphicsView;
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+class BinarySceneReader;
+
+/// Opens a binary scene file (see BinaryScene) without loading it.
+///
+/// The file is memory mapped and only its header and model name table are
+/// read, so opening does not depend on the size of the scene. Nodes are
+/// added to the DataFlowScene ("materialized") on request: by id, by scene
+/// region, or for whatever a view shows. Materializing a node also
+/// materializes everything upstream of it, so that its inputs can be
+/// evaluated, and connects it to the materialized nodes around it.
+///
+/// The id lookup, the spatial grid and the connection table are each built
+/// the first time they are needed, by scanning the fixed size node records
+/// only; model states are decoded for materialized nodes alone.
+///
+/// A node is materialized at most once; removing it from the scene
+/// afterwards does not bring it back. Call `materializeAll()` before saving
+/// to keep the nodes that were never looked at.
+class NODE_EDITOR_PUBLIC LazyScene
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  LazyScene(DataFlowScene& scene, QObject* parent = nullptr);
+
+  ~LazyScene();
+
+  /// Maps `fileName`, false if it cannot be mapped or is not a binary scene
+  bool
+  open(QString const& fileName);
+
+  /// Unmaps the file; materialized nodes stay in the scene
+  void
+  close();
+
+  bool
+  isOpen() const { return _reader != nullptr; }
+
+  QString
+  errorString() const { return _errorString; }
+
+  std::size_t
+  nodeCount() const;
+
+  std::size_t
+  materializedCount() const { return _materializedCount; }
+
+  bool
+  contains(QUuid const& id);
+
+  bool
+  isMaterialized(QUuid const& id);
+
+  QPointF
+  nodePosition(QUuid const& id);
+
+  /// Node ids whose position lies in `rect`
+  std::vector<QUuid>
+  nodesIn(QRectF const& rect);
+
+  /// Returns false if `id` is not in the file
+  bool
+  materialize(QUuid const& id);
+
+  void
+  materializeRegion(QRectF const& rect);
+
+  void
+  materializeAll();
+
+  /// Materializes what `view` shows, now and whenever it scrolls or zooms
+  void
+  follow(QGraphicsView* view);
+
+  void
+  unfollow();
+
+signals:
+
+  void
+  nodesMaterialized(std::size_t count);
+
+private:
+
+  using Record = std::uint32_t;
+
+  static constexpr Record NoRecord = ~Record(0);
+
+  /// A connection seen from one of its nodes. `node` is NoRecord if the
+  /// other end is not in the file and only known by `external`.
+  struct Link
+  {
+    Record    node;
+    QUuid     external;
+    PortIndex ownPort;
+    PortIndex otherPort;
+  };
+
+  Record
+  record(QUuid const& id);
+
+  void
+  buildIdIndex();
+
+  void
+  buildGrid();
+
+  bool
+  buildLinks();
+
+  /// Creates the nodes of `records` and their upstream closure, then
+  /// connects them
+  void
+  materializeRecords(std::vector<Record> records);
+
+  void
+  materializeVisible();
+
+  static std::uint64_t
+  cellKey(int x, int y);
+
+private:
+
+  DataFlowScene& _scene;
+
+  QFile  _file;
+  uchar* _mapped = nullptr;
+
+  std::unique_ptr<BinarySceneReader> _reader;
+
+  QString _errorString;
+
+  std::vector<bool> _materialized;
+  std::size_t       _materializedCount = 0;
+
+  // built on first use
+  std::unordered_map<QUuid, Record> _ids;
+
+  std::unordered_map<std::uint64_t, std::vector<Record>> _grid;
+  bool                                                   _gridBuilt = false;
+
+  // per record, connections to inputs and from outputs
+  std::vector<std::vector<Link>> _upstream;
+  std::vector<std::vector<Link>> _downstream;
+  bool                           _linksBuilt = false;
+
+  QGraphicsView*                       _view = nullptr;
+  std::vector<QMetaObject::Connection> _viewConnections;
+};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QStyleOptionGraphicsItem>
+
+namespace QtNodes
+{
+
+/// How much of an item the painters draw, depending on how large it shows
+enum class DetailLevel
+{
+  Minimal,    ///< plain shapes: a filled rectangle, straight lines
+  Simplified, ///< no text, flat fills, no decorations
+  Full
+};
+
+/// Scale of an item on screen below which it is drawn simplified, and
+/// below which it is drawn minimal
+constexpr qreal SimplifiedDetailScale = 0.5;
+constexpr qreal MinimalDetailScale    = 0.2;
+
+inline
+DetailLevel
+detailLevel(qreal scale)
+{
+  if (scale < MinimalDetailScale)
+    return DetailLevel::Minimal;
+
+  if (scale < SimplifiedDetailScale)
+    return DetailLevel::Simplified;
+
+  return DetailLevel::Full;
+}
+
+inline
+DetailLevel
+detailLevel(QStyleOptionGraphicsItem const& option, QPainter const& painter)
+{
+  return detailLevel(option.levelOfDetailFromTransform(painter.worldTransform()));
+}
+}
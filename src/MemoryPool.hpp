@@ -0,0 +1,200 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <algorithm>
+#include <unordered_map>
+
+#include "make_unique.hpp"
+
+namespace QtNodes
+{
+
+/// Hands out fixed-size blocks carved from large slabs and recycles freed
+/// blocks through an intrusive free list. Memory goes back to the system
+/// only when the pool is destroyed.
+class FixedBlockPool
+{
+public:
+
+  explicit
+  FixedBlockPool(std::size_t blockSize, std::size_t blocksPerSlab = 1024)
+    : _blockSize(roundUp(std::max(blockSize, sizeof(FreeBlock))))
+    , _blocksPerSlab(blocksPerSlab)
+  {}
+
+  FixedBlockPool(FixedBlockPool const&) = delete;
+  FixedBlockPool& operator=(FixedBlockPool const&) = delete;
+
+  void*
+  allocate()
+  {
+    if (!_freeList)
+      grow();
+
+    FreeBlock* block = _freeList;
+    _freeList = block->next;
+
+    return block;
+  }
+
+  void
+  deallocate(void* p)
+  {
+    auto block = static_cast<FreeBlock*>(p);
+
+    block->next = _freeList;
+    _freeList   = block;
+  }
+
+private:
+
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  static std::size_t
+  roundUp(std::size_t size)
+  {
+    std::size_t const align = alignof(std::max_align_t);
+
+    return (size + align - 1) / align * align;
+  }
+
+  void
+  grow()
+  {
+    // operator new[] on char is aligned for any fundamental type
+    _slabs.emplace_back(new char[_blockSize * _blocksPerSlab]);
+
+    char* slab = _slabs.back().get();
+
+    for (std::size_t i = _blocksPerSlab; i > 0; --i)
+    {
+      deallocate(slab + (i - 1) * _blockSize);
+    }
+  }
+
+private:
+
+  std::size_t _blockSize;
+  std::size_t _blocksPerSlab;
+
+  FreeBlock* _freeList = nullptr;
+
+  std::vector<std::unique_ptr<char[]> > _slabs;
+};
+
+
+/// One FixedBlockPool per block size, shared by all allocators rebound from
+/// the same PoolAllocator (e.g. by `std::allocate_shared`)
+class MemoryPool
+{
+public:
+
+  void*
+  allocate(std::size_t size)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return pool(size).allocate();
+  }
+
+  void
+  deallocate(void* p, std::size_t size)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    pool(size).deallocate(p);
+  }
+
+private:
+
+  FixedBlockPool&
+  pool(std::size_t size)
+  {
+    auto iter = _pools.find(size);
+
+    if (iter == _pools.end())
+    {
+      iter = _pools.emplace(size, std::make_unique<FixedBlockPool>(size)).first;
+    }
+
+    return *iter->second;
+  }
+
+private:
+
+  std::mutex _mutex;
+
+  std::unordered_map<std::size_t, std::unique_ptr<FixedBlockPool> > _pools;
+};
+
+
+/// Standard allocator drawing single objects from a MemoryPool.
+/// Keeps the pool alive for as long as any memory allocated from it can be
+/// released, so objects may outlive the owner of the pool.
+template<typename T>
+class PoolAllocator
+{
+public:
+
+  using value_type = T;
+
+  explicit
+  PoolAllocator(std::shared_ptr<MemoryPool> pool)
+    : _pool(std::move(pool))
+  {}
+
+  template<typename U>
+  PoolAllocator(PoolAllocator<U> const& other)
+    : _pool(other.pool())
+  {}
+
+  T*
+  allocate(std::size_t n)
+  {
+    if (n != 1)
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+
+    return static_cast<T*>(_pool->allocate(sizeof(T)));
+  }
+
+  void
+  deallocate(T* p, std::size_t n)
+  {
+    if (n != 1)
+    {
+      ::operator delete(p);
+      return;
+    }
+
+    _pool->deallocate(p, sizeof(T));
+  }
+
+  std::shared_ptr<MemoryPool> const&
+  pool() const { return _pool; }
+
+private:
+
+  std::shared_ptr<MemoryPool> _pool;
+};
+
+template<typename T, typename U>
+bool
+operator==(PoolAllocator<T> const& lhs, PoolAllocator<U> const& rhs)
+{
+  return lhs.pool() == rhs.pool();
+}
+
+template<typename T, typename U>
+bool
+operator!=(PoolAllocator<T> const& lhs, PoolAllocator<U> const& rhs)
+{
+  return !(lhs == rhs);
+}
+
+} // namespace QtNodes
@@ -0,0 +1,282 @@
+#include "ModelPalette.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include <QtCore/QStringList>
+
+#include "FlowSceneModel.hpp"
+
+namespace QtNodes {
+
+void
+ModelPalette::
+rebuild(FlowSceneModel const& model)
+{
+  _entries.clear();
+  _indexed.clear();
+  _byCategory.clear();
+  _trigrams.clear();
+  _lastQuery.clear();
+  _lastMatches.clear();
+
+  QStringList const names = model.modelRegistry();
+
+  _entries.reserve(names.size());
+  _indexed.reserve(names.size());
+
+  std::map<std::pair<QString, QString>, std::size_t> sorted;
+
+  for (QString const& name : names)
+  {
+    std::size_t const index = _entries.size();
+
+    _entries.push_back(Entry{name, model.nodeTypeCategory(name)});
+
+    QString folded = name.toCaseFolded();
+    _indexed.push_back(IndexedEntry{folded, characterMask(folded)});
+
+    for (int i = 0; i + 3 <= folded.size(); ++i)
+    {
+      auto& postings = _trigrams[folded.mid(i, 3)];
+
+      // names repeating a trigram would otherwise be listed twice
+      if (postings.empty() || postings.back() != index)
+        postings.push_back(index);
+    }
+
+    sorted.emplace(std::make_pair(_entries.back().category, name), index);
+  }
+
+  for (auto const& item : sorted)
+  {
+    _byCategory.push_back(item.second);
+  }
+}
+
+
+std::vector<std::size_t> const&
+ModelPalette::
+match(QString const& query)
+{
+  QString const folded = query.toCaseFolded();
+
+  if (folded.isEmpty())
+  {
+    _lastQuery.clear();
+    _lastMatches.clear();
+    return _lastMatches;
+  }
+
+  std::vector<std::pair<int, std::size_t>> scored;
+
+  if (!_lastQuery.isEmpty() && folded.startsWith(_lastQuery))
+  {
+    // anything matching the longer query matched the shorter one
+    for (std::size_t entry : _lastMatches)
+    {
+      int const s = score(entry, folded);
+
+      if (s >= 0)
+        scored.emplace_back(s, entry);
+    }
+  }
+  else
+  {
+    std::vector<bool> done(_entries.size(), false);
+
+    if (folded.size() >= 3)
+    {
+      for (std::size_t entry : substringCandidates(folded))
+      {
+        int const position = _indexed[entry].folded.indexOf(folded);
+
+        if (position >= 0)
+        {
+          scored.emplace_back(substringScore(entry, folded, position), entry);
+          done[entry] = true;
+        }
+      }
+    }
+
+    std::uint64_t const needed = characterMask(folded);
+
+    for (std::size_t entry = 0; entry < _entries.size(); ++entry)
+    {
+      if (done[entry] || (_indexed[entry].characters & needed) != needed)
+        continue;
+
+      int const s = folded.size() >= 3 ? fuzzyScore(entry, folded) : score(entry, folded);
+
+      if (s >= 0)
+        scored.emplace_back(s, entry);
+    }
+  }
+
+  std::sort(scored.begin(), scored.end(),
+            [this](std::pair<int, std::size_t> const& lhs,
+                   std::pair<int, std::size_t> const& rhs)
+            {
+              if (lhs.first != rhs.first)
+                return lhs.first > rhs.first;
+
+              return _entries[lhs.second].name < _entries[rhs.second].name;
+            });
+
+  _lastQuery = folded;
+  _lastMatches.clear();
+
+  for (auto const& item : scored)
+  {
+    _lastMatches.push_back(item.second);
+  }
+
+  return _lastMatches;
+}
+
+
+std::uint64_t
+ModelPalette::
+characterMask(QString const& folded)
+{
+  std::uint64_t mask = 0;
+
+  for (QChar c : folded)
+  {
+    ushort const u = c.unicode();
+
+    unsigned bit;
+    if (u >= 'a' && u <= 'z')
+      bit = u - 'a';
+    else if (u >= '0' && u <= '9')
+      bit = 26 + (u - '0');
+    else
+      bit = 36 + u % 28;
+
+    mask |= std::uint64_t(1) << bit;
+  }
+
+  return mask;
+}
+
+
+int
+ModelPalette::
+score(std::size_t entry, QString const& query) const
+{
+  int const position = _indexed[entry].folded.indexOf(query);
+
+  if (position >= 0)
+    return substringScore(entry, query, position);
+
+  return fuzzyScore(entry, query);
+}
+
+
+int
+ModelPalette::
+substringScore(std::size_t entry, QString const& query, int position) const
+{
+  // any substring ranks above any scattered match
+  int s = 10000 - 8 * position - (_indexed[entry].folded.size() - query.size());
+
+  if (position == 0)
+    s += 2000;
+  else if (wordStart(entry, position))
+    s += 1000;
+
+  return s;
+}
+
+
+int
+ModelPalette::
+fuzzyScore(std::size_t entry, QString const& query) const
+{
+  QString const& folded = _indexed[entry].folded;
+
+  int s        = 5000;
+  int position = 0;
+  int previous = -1;
+
+  for (QChar c : query)
+  {
+    position = folded.indexOf(c, position);
+
+    if (position < 0)
+      return -1;
+
+    // prefer matches on word starts and with small gaps
+    if (wordStart(entry, position))
+      s += 40;
+
+    if (previous >= 0)
+      s -= 4 * (position - previous - 1);
+    else
+      s -= 8 * position;
+
+    previous = position++;
+  }
+
+  return std::max(s - (folded.size() - query.size()), 0);
+}
+
+
+bool
+ModelPalette::
+wordStart(std::size_t entry, int position) const
+{
+  if (position == 0)
+    return true;
+
+  QString const& name = _entries[entry].name;
+
+  // case folding may change the length of unusual names
+  if (position >= name.size())
+    return false;
+
+  QChar const before = name[position - 1];
+  QChar const at     = name[position];
+
+  return !before.isLetterOrNumber() ||
+         (at.isUpper() && before.isLower());
+}
+
+
+std::vector<std::size_t>
+ModelPalette::
+substringCandidates(QString const& query) const
+{
+  // intersect the posting lists of all trigrams, rarest first
+  std::vector<std::vector<std::size_t> const*> lists;
+
+  for (int i = 0; i + 3 <= query.size(); ++i)
+  {
+    auto iter = _trigrams.find(query.mid(i, 3));
+
+    if (iter == _trigrams.end())
+      return {};
+
+    lists.push_back(&iter->second);
+  }
+
+  std::sort(lists.begin(), lists.end(),
+            [](std::vector<std::size_t> const* lhs, std::vector<std::size_t> const* rhs)
+            { return lhs->size() < rhs->size(); });
+
+  std::vector<std::size_t> result = *lists.front();
+  std::vector<std::size_t> next;
+
+  for (std::size_t i = 1; i < lists.size() && !result.empty(); ++i)
+  {
+    next.clear();
+    std::set_intersection(result.begin(), result.end(),
+                          lists[i]->begin(), lists[i]->end(),
+                          std::back_inserter(next));
+    result.swap(next);
+  }
+
+  return result;
+}
+}
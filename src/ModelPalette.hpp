@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include <QtCore/QString>
+
+#include "Export.hpp"
+#include "QStringStdHash.hpp"
+
+namespace QtNodes
+{
+
+class FlowSceneModel;
+
+/// Searchable catalogue of the models a FlowSceneModel can create.
+///
+/// Built once per registry change. Queries are matched case-insensitively
+/// against model names, substrings first (found through a trigram index),
+/// then in-order fuzzy matches, and returned best first. A query that
+/// extends the previous one only re-checks the previous matches, so typing
+/// narrows the results without rescanning the catalogue.
+class NODE_EDITOR_PUBLIC ModelPalette
+{
+public:
+
+  struct Entry
+  {
+    QString name;
+    QString category;
+  };
+
+public:
+
+  void
+  rebuild(FlowSceneModel const& model);
+
+  std::vector<Entry> const&
+  entries() const { return _entries; }
+
+  /// Indices into `entries()` grouped by category, categories and names
+  /// sorted
+  std::vector<std::size_t> const&
+  byCategory() const { return _byCategory; }
+
+  /// Indices into `entries()` of the models matching `query`, best first.
+  /// An empty query matches nothing.
+  std::vector<std::size_t> const&
+  match(QString const& query);
+
+private:
+
+  struct IndexedEntry
+  {
+    QString       folded;
+    std::uint64_t characters;
+  };
+
+  static std::uint64_t
+  characterMask(QString const& folded);
+
+  /// Score of `query` against the entry, or -1 if it does not match
+  int
+  score(std::size_t entry, QString const& query) const;
+
+  int
+  substringScore(std::size_t entry, QString const& query, int position) const;
+
+  /// Score of the characters of `query` appearing in order, or -1
+  int
+  fuzzyScore(std::size_t entry, QString const& query) const;
+
+  bool
+  wordStart(std::size_t entry, int position) const;
+
+  std::vector<std::size_t>
+  substringCandidates(QString const& query) const;
+
+private:
+
+  std::vector<Entry>        _entries;
+  std::vector<IndexedEntry> _indexed;
+  std::vector<std::size_t>  _byCategory;
+
+  // trigram of a folded name -> entries containing it, ascending
+  std::unordered_map<QString, std::vector<std::size_t>> _trigrams;
+
+  QString                  _lastQuery;
+  std::vector<std::size_t> _lastMatches;
+};
+}
@@ -25,6 +25,10 @@ Node(std::unique_ptr<NodeDataModel> && dataModel, QUuid const& id)
 
   _inConnections.resize(nodeDataModel()->nPorts(PortType::In));
   _outConnections.resize(nodeDataModel()->nPorts(PortType::Out));
+
+  _validationState   = _nodeDataModel->validationState();
+  _validationMessage = _nodeDataModel->validationMessage();
+  _caption           = _nodeDataModel->caption();
 }
 
 
@@ -80,11 +84,13 @@ position() const {
 }
 void 
 Node::
-setPosition(QPointF const& newPos) {
+setPosition(QPointF const& newPos, bool notify) {
   _position = newPos;
   
   // emit position changed signal
-  emit positionChanged(newPos);
+  if (notify) {
+    emit positionChanged(newPos);
+  }
 }
 
 NodeDataModel*
@@ -95,6 +101,16 @@ nodeDataModel() const
 }
 
 
+std::unique_ptr<NodeDataModel>
+Node::
+releaseNodeDataModel()
+{
+  disconnect(_nodeDataModel.get(), nullptr, this, nullptr);
+
+  return std::move(_nodeDataModel);
+}
+
+
 std::vector<Connection*>&
 Node::
 connections(PortType pType, PortIndex idx)
@@ -107,17 +123,53 @@ connections(PortType pType, PortIndex idx)
 void
 Node::
 propagateData(std::shared_ptr<NodeData> nodeData,
-              PortIndex inPortIndex) const
+              PortIndex inPortIndex)
 {
   _nodeDataModel->setInData(nodeData, inPortIndex);
+
+  checkValidation();
+  checkCaption();
+}
+
+
+void
+Node::
+onDataUpdated(PortIndex)
+{
+  checkValidation();
+  checkCaption();
+}
+
+
+void
+Node::
+checkValidation()
+{
+  auto state = _nodeDataModel->validationState();
+  auto msg   = _nodeDataModel->validationMessage();
+
+  if (state != _validationState || msg != _validationMessage)
+  {
+    _validationState   = state;
+    _validationMessage = msg;
+
+    emit validationChanged();
+  }
 }
 
 
 void
 Node::
-onDataUpdated(PortIndex index)
+checkCaption()
 {
-  auto nodeData = _nodeDataModel->outData(index);
+  auto caption = _nodeDataModel->caption();
+
+  if (caption != _caption)
+  {
+    _caption = caption;
+
+    emit captionChanged();
+  }
 }
 
 } // namespace QtNodes
@@ -16,6 +16,7 @@
 #include "NodeGraphicsObject.hpp"
 #include "ConnectionGraphicsObject.hpp"
 #include "Serializable.hpp"
+#include "FlowSceneModel.hpp"
 
 namespace QtNodes
 {
@@ -56,12 +57,18 @@ public:
 public:
   
   QPointF position() const;
-  void setPosition(QPointF const& newPos);
+  /// Without `notify`, `positionChanged` is left for the caller to emit
+  void setPosition(QPointF const& newPos, bool notify = true);
   
 public:
 
   NodeDataModel*
   nodeDataModel() const;
+
+  /// Disconnects the model from this node and hands it over, e.g. for
+  /// recycling. The node is unusable afterwards.
+  std::unique_ptr<NodeDataModel>
+  releaseNodeDataModel();
   
   std::vector<Connection*>&
   connections(PortType pType, PortIndex pIdx);
@@ -69,9 +76,11 @@ public:
 public slots: // data propagation
 
   /// Propagates incoming data to the underlying model.
+  /// Emits `validationChanged` or `captionChanged` if the model's
+  /// validation or caption changed as a result.
   void
   propagateData(std::shared_ptr<NodeData> nodeData,
-                PortIndex inPortIndex) const;
+                PortIndex inPortIndex);
 
   /// Fetches data from model's OUT #index port
   /// and propagates it to the connection
@@ -82,12 +91,29 @@ signals:
   
   void positionChanged(QPointF const& newPos);
 
+  void validationChanged();
+
+  void captionChanged();
+
+private:
+
+  void checkValidation();
+
+  void checkCaption();
+
 private:
   
   std::vector<std::vector<Connection*>> _inConnections, _outConnections;
   
   QPointF _position;
 
+  // last validation seen, to detect changes
+  NodeValidationState _validationState = NodeValidationState::Valid;
+  QString _validationMessage;
+
+  // last caption seen, captions may depend on the data
+  QString _caption;
+
   // data
   std::unique_ptr<NodeDataModel> _nodeDataModel;
   QUuid _index;
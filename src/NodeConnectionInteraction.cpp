@@ -1,5 +1,7 @@
 #include "NodeConnectionInteraction.hpp"
 
+#include <vector>
+
 #include "ConnectionGraphicsObject.hpp"
 #include "NodeGraphicsObject.hpp"
 #include "NodeDataModel.hpp"
@@ -17,7 +19,7 @@ NodeConnectionInteraction(NodeIndex const& node,
 
 bool
 NodeConnectionInteraction::
-canConnect(PortIndex &portIndex, bool& typeConversionNeeded, QString& converterModel) const
+canConnect(PortIndex &portIndex, bool& typeConversionNeeded, QStringList& converterChain) const
 {
   typeConversionNeeded = false;
 
@@ -48,7 +50,7 @@ canConnect(PortIndex &portIndex, bool& typeConversionNeeded, QString& converterM
   if (!nodePortIsEmpty(requiredPort, portIndex))
     return false;
 
-  // 4) Connection type equals node port type, or there is a registered type conversion that can translate between the two
+  // 4) Connection type equals node port type, or there is a chain of registered type conversions that can translate between the two
 
   auto connectionDataType = _connection->dataType();
 
@@ -60,9 +62,13 @@ canConnect(PortIndex &portIndex, bool& typeConversionNeeded, QString& converterM
   {
     if (requiredPort == PortType::In)
     {
-      return typeConversionNeeded = (converterModel = modelTarget->converterNode(connectionDataType, candidateNodeDataType)) != QString{};
+      converterChain = modelTarget->converterNodeChain(connectionDataType, candidateNodeDataType);
+    }
+    else
+    {
+      converterChain = modelTarget->converterNodeChain(candidateNodeDataType, connectionDataType);
     }
-    return typeConversionNeeded = (converterModel = modelTarget->converterNode(candidateNodeDataType, connectionDataType)) != QString{};
+    return typeConversionNeeded = !converterChain.isEmpty();
   }
 
   return true;
@@ -77,8 +83,8 @@ tryConnect() const
   PortIndex portIndex = INVALID;
   bool typeConversionNeeded = false;
 
-  QString typeConverterModel;
-  if (!canConnect(portIndex, typeConversionNeeded, typeConverterModel))
+  QStringList typeConverterChain;
+  if (!canConnect(portIndex, typeConversionNeeded, typeConverterChain))
   {
     return false;
   }
@@ -96,51 +102,74 @@ tryConnect() const
   
   auto outNodePortIndex = _connection->portIndex(connectedPort);
   
-  /// 1.5) If the connection is possible but a type conversion is needed, add a converter node to the scene, and connect it properly
+  /// 1.5) If the connection is possible but a type conversion is needed, add the converter nodes to the scene, and connect them in a row
   if (typeConversionNeeded)
   {
+    //The chain runs from the out port to the in port, whichever end the user started the connection from.
+    NodeIndex upstreamNode   = requiredPort == PortType::In ? outNode : _node;
+    PortIndex upstreamPort   = requiredPort == PortType::In ? outNodePortIndex : portIndex;
+    NodeIndex downstreamNode = requiredPort == PortType::In ? _node : outNode;
+    PortIndex downstreamPort = requiredPort == PortType::In ? portIndex : outNodePortIndex;
+
+    // try to create the converter nodes
+    std::vector<NodeIndex> converterNodes;
+    for (QString const& converterModel : typeConverterChain)
+    {
+      QUuid newNodeID = model->addNode(converterModel, QPointF{});
+      if (newNodeID.isNull())
+      {
+        // couldn't create the node, take back the ones already made
+        for (NodeIndex const& created : converterNodes)
+        {
+          model->removeNode(created);
+        }
+        return false;
+      }
+      converterNodes.push_back(model->nodeIndex(newNodeID));
+    }
 
-    
-    // try to create the converter  node
-    QUuid newNodeID = model->addNode(typeConverterModel, QPointF{});
-    if (!newNodeID.isNull()) {
-      // node was created!
-      NodeIndex converterNode = model->nodeIndex(newNodeID);
-      
-      // get the graphics object
-      auto convertedGraphics = _connection->flowScene().nodeGraphicsObject(converterNode);
-      Q_ASSERT(convertedGraphics);
-      
-      auto thisNodeGraphics = _connection->flowScene().nodeGraphicsObject(_node);
-      
-      auto outGraphics = _connection->flowScene().nodeGraphicsObject(outNode);
-      
-      // move it
-      auto converterNodePos = NodeGeometry::calculateNodePositionBetweenNodePorts(portIndex, requiredPort, *thisNodeGraphics, outNodePortIndex, connectedPort, *outGraphics, convertedGraphics->geometry());
-      
-      // if this fails, well at least we tried--keep on going
-      model->moveNode(converterNode, converterNodePos);
-      
-      // connect it in all the right places
-      
-      //The connection order is different based on if the users connection was started from an input port, or an output port.
-      if (requiredPort == PortType::In)
+    // spread them evenly on the line between the two ports; nodes without
+    // graphics, e.g. outside of a virtualized view, count by their location
+    auto& scene = _connection->flowScene();
+
+    auto portPosition = [&](NodeIndex const& node, PortIndex port, PortType portType)
+    {
+      auto graphics = scene.nodeGraphicsObject(node);
+      if (!graphics)
       {
-        // hopefully this works...don't fail even if it doesn't
-        model->addConnection(converterNode, 0, _node, portIndex);
-        model->addConnection(outNode, outNodePortIndex, converterNode, 0);
+        return model->nodeLocation(node);
       }
-      else
+      return graphics->pos() + graphics->geometry().portScenePosition(port, portType);
+    };
+
+    QPointF from = portPosition(upstreamNode, upstreamPort, PortType::Out);
+    QPointF to   = portPosition(downstreamNode, downstreamPort, PortType::In);
+
+    for (size_t i = 0; i < converterNodes.size(); ++i)
+    {
+      double  t      = double(i + 1) / double(converterNodes.size() + 1);
+      QPointF center = from + (to - from) * t;
+
+      QPointF halfSize;
+      if (auto convertedGraphics = scene.nodeGraphicsObject(converterNodes[i]))
       {
-        // hopefully this works...don't fail even if it doesn't
-        model->addConnection(converterNode, 0, outNode, outNodePortIndex);
-        model->addConnection(_node, portIndex, converterNode, 0);
+        halfSize = QPointF(convertedGraphics->geometry().width() / 2.0,
+                           convertedGraphics->geometry().height() / 2.0);
       }
 
-    } else {
-      // couln't create the node
-      return false;
+      // if this fails, well at least we tried--keep on going
+      model->moveNode(converterNodes[i], center - halfSize);
+    }
+
+    // connect it in all the right places, downstream first so data only flows once the chain is complete
+
+    // hopefully this works...don't fail even if it doesn't
+    model->addConnection(converterNodes.back(), 0, downstreamNode, downstreamPort);
+    for (size_t i = converterNodes.size() - 1; i > 0; --i)
+    {
+      model->addConnection(converterNodes[i - 1], 0, converterNodes[i], 0);
     }
+    model->addConnection(upstreamNode, upstreamPort, converterNodes.front(), 0);
 
     return true;
   }
@@ -103,6 +103,37 @@ public:
   bool
   resizable() const { return false; }
 
+  /// Puts the model back into the state of a new instance, so that
+  /// DataModelRegistry can hand it out again instead of constructing one
+  /// (see `DataModelRegistry::setPoolCapacity`). Return false if that is
+  /// not possible; the model is destroyed then. A recycled model keeps its
+  /// embedded widget across uses and must delete it in its destructor.
+  virtual
+  bool
+  resetState() { return false; }
+
+  /// Whether `save()` and `restore()` may run on a worker thread while
+  /// other models are (de)serialized. DataFlowScene then does so in
+  /// parallel when saving and loading scenes. Only say yes if they touch
+  /// no widgets and no state shared with other models.
+  virtual
+  bool
+  serializationThreadSafe() const { return false; }
+
+  /// Whether NodeOutputCache should persist this model's outputs, for
+  /// models expensive to evaluate. Needs `restoreOutData` and serializable
+  /// output types, see `DataModelRegistry::registerDataSerializer`.
+  virtual
+  bool
+  cacheOutData() const { return false; }
+
+  /// Takes `nodeData` as output `port`, as if computed from the current
+  /// inputs, without recomputing or emitting `dataUpdated`. Return false
+  /// if that is not supported.
+  virtual
+  bool
+  restoreOutData(PortIndex, std::shared_ptr<NodeData>) { return false; }
+
   virtual
   NodeValidationState
   validationState() const { return NodeValidationState::Valid; }
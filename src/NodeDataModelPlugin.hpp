@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QtCore/QtPlugin>
+
+#include "Export.hpp"
+
+namespace QtNodes
+{
+
+class DataModelRegistry;
+
+/// Interface implemented by shared libraries providing node models, see
+/// `DataModelRegistry::loadPlugins`.
+///
+/// Next to `Q_PLUGIN_METADATA(IID NodeDataModelPlugin_iid FILE "...json")`
+/// the plugin lists its models in the metadata file, which is read without
+/// loading the library:
+///
+///     { "models": [
+///         { "name": "Blur", "category": "Filters" },
+///         { "name": "IntToDouble", "category": "Converters",
+///           "converter": { "from": { "id": "int",    "name": "Integer" },
+///                          "to":   { "id": "double", "name": "Decimal" } } } ] }
+///
+/// `registerDataModels` must register every listed model under the same
+/// name; it is called once, when the first of them is created.
+class NODE_EDITOR_PUBLIC NodeDataModelPlugin
+{
+public:
+
+  virtual
+  ~NodeDataModelPlugin() = default;
+
+  virtual void
+  registerDataModels(DataModelRegistry& registry) = 0;
+};
+}
+
+#define NodeDataModelPlugin_iid "org.nodeeditor.NodeDataModelPlugin/1.0"
+
+Q_DECLARE_INTERFACE(QtNodes::NodeDataModelPlugin, NodeDataModelPlugin_iid)
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+#include <QtCore/QString>
+
+#include "PortType.hpp"
+#include "NodeData.hpp"
+#include "NodeStyle.hpp"
+#include "FlowSceneModel.hpp"
+
+namespace QtNodes
+{
+
+struct PortDescriptor
+{
+  QString          caption;
+  NodeDataType     dataType;
+  ConnectionPolicy connectionPolicy = ConnectionPolicy::Many;
+
+  /// Caption shown next to the port: the port caption,
+  /// or the data type name if the caption is empty
+  QString const&
+  label() const
+  { return caption.isEmpty() ? dataType.name : caption; }
+};
+
+/// Immutable snapshot of everything needed to measure and paint a node.
+///
+/// Obtained through `FlowSceneModel::nodeDescriptor` in a single call and
+/// shared between the geometry and the painter of a node. A new descriptor
+/// (with a new `version`) has to be requested after the model signals a
+/// change to the node.
+struct NodeDescriptor
+{
+  std::size_t version = 0;
+
+  QString caption;
+
+  bool resizable = false;
+
+  NodeValidationState validationState = NodeValidationState::Valid;
+  QString             validationMessage;
+
+  NodeStyle style;
+
+  std::vector<PortDescriptor> inPorts;
+  std::vector<PortDescriptor> outPorts;
+
+public:
+
+  std::vector<PortDescriptor> const&
+  ports(PortType portType) const
+  { return portType == PortType::In ? inPorts : outPorts; }
+
+  unsigned int
+  portCount(PortType portType) const
+  { return static_cast<unsigned int>(ports(portType).size()); }
+
+  PortDescriptor const&
+  port(PortType portType, PortIndex index) const
+  { return ports(portType)[static_cast<std::size_t>(index)]; }
+};
+
+using NodeDescriptorPtr = std::shared_ptr<NodeDescriptor const>;
+
+} // namespace QtNodes
@@ -7,6 +7,7 @@
 #include "NodeIndex.hpp"
 #include "NodeGraphicsObject.hpp"
 #include "FlowSceneModel.hpp"
+#include "NodeDescriptor.hpp"
 
 #include "StyleCollection.hpp"
 
@@ -23,8 +24,6 @@ NodeGeometry(const NodeIndex& index)
   , _entryHeight(20)
   , _spacing(20)
   , _hovered(false)
-  , _nSources(index.model()->nodePortCount(index, PortType::Out))
-  , _nSinks(index.model()->nodePortCount(index, PortType::In))
   , _draggingPos(-1000, -1000)
   , _nodeIndex(index)
   , _fontMetrics(QFont())
@@ -33,6 +32,30 @@ NodeGeometry(const NodeIndex& index)
   QFont f; f.setBold(true);
 
   _boldFontMetrics = QFontMetrics(f);
+
+  _nSources = descriptor().portCount(PortType::Out);
+  _nSinks   = descriptor().portCount(PortType::In);
+}
+
+
+NodeDescriptor const&
+NodeGeometry::
+descriptor() const
+{
+  if (!_descriptor)
+  {
+    _descriptor = _nodeIndex.model()->nodeDescriptor(_nodeIndex);
+  }
+
+  return *_descriptor;
+}
+
+
+void
+NodeGeometry::
+invalidateDescriptor()
+{
+  _descriptor.reset();
 }
 
 
@@ -53,7 +76,7 @@ QRectF
 NodeGeometry::
 boundingRect() const
 {
-  auto const &nodeStyle = _nodeIndex.model()->nodeStyle(_nodeIndex);
+  auto const &nodeStyle = descriptor().style;
 
   double addon = 4 * nodeStyle.ConnectionPointDiameter;
 
@@ -97,7 +120,7 @@ recalculateSize() const
 
   _width = std::max(_width, captionWidth());
 
-  if (_nodeIndex.model()->nodeValidationState(_nodeIndex) != NodeValidationState::Valid)
+  if (descriptor().validationState != NodeValidationState::Valid)
   {
     _width   = std::max(_width, validationWidth());
     _height += validationHeight() + _spacing;
@@ -132,7 +155,7 @@ portScenePosition(int index,
                   PortType portType,
                   QTransform t) const
 {
-  auto const &nodeStyle = _nodeIndex.model()->nodeStyle(_nodeIndex);
+  auto const &nodeStyle = descriptor().style;
 
   unsigned int step = _entryHeight + _spacing;
 
@@ -188,7 +211,7 @@ checkHitScenePoint(PortType portType,
 
   double const tolerance = 2.0 * nodeStyle.ConnectionPointDiameter;
 
-  size_t const nItems = _nodeIndex.model()->nodePortCount(_nodeIndex, portType);
+  size_t const nItems = descriptor().portCount(portType);
 
   for (size_t i = 0; i < nItems; ++i)
   {
@@ -227,7 +250,7 @@ widgetPosition() const
 {
   if (auto w = _nodeIndex.model()->nodeWidget(_nodeIndex))
   {
-    if (_nodeIndex.model()->nodeValidationState(_nodeIndex) != NodeValidationState::Valid)
+    if (descriptor().validationState != NodeValidationState::Valid)
     {
       return QPointF(_spacing + portWidth(PortType::In),
                      (captionHeight() + _height - validationHeight() - _spacing - w->height()) / 2.0);
@@ -245,8 +268,7 @@ unsigned int
 NodeGeometry::
 captionHeight() const
 {
-
-  QString name = _nodeIndex.model()->nodeCaption(_nodeIndex);
+  QString const &name = descriptor().caption;
 
   return _boldFontMetrics.boundingRect(name).height();
 }
@@ -256,8 +278,7 @@ unsigned int
 NodeGeometry::
 captionWidth() const
 {
-
-  QString name = _nodeIndex.model()->nodeCaption(_nodeIndex);
+  QString const &name = descriptor().caption;
 
   return _boldFontMetrics.boundingRect(name).width();
 }
@@ -267,7 +288,7 @@ unsigned int
 NodeGeometry::
 validationHeight() const
 {
-  QString msg = _nodeIndex.model()->nodeValidationMessage(_nodeIndex);
+  QString const &msg = descriptor().validationMessage;
 
   return _boldFontMetrics.boundingRect(msg).height();
 }
@@ -277,46 +298,21 @@ unsigned int
 NodeGeometry::
 validationWidth() const
 {
-  QString msg = _nodeIndex.model()->nodeValidationMessage(_nodeIndex);
+  QString const &msg = descriptor().validationMessage;
 
   return _boldFontMetrics.boundingRect(msg).width();
 }
 
 
-QPointF
-NodeGeometry::
-calculateNodePositionBetweenNodePorts(PortIndex targetPortIndex, PortType targetPort, const NodeGraphicsObject& targetNode, 
-                                      PortIndex sourcePortIndex, PortType sourcePort, const NodeGraphicsObject& sourceNode, 
-                                      const NodeGeometry& newNodeGeom)
-{
-  //Calculating the nodes position in the scene. It'll be positioned half way between the two ports that it "connects". 
-  //The first line calculates the halfway point between the ports (node position + port position on the node for both nodes averaged).
-  //The second line offsets this coordinate with the size of the new node, so that the new nodes center falls on the originally
-  //calculated coordinate, instead of it's upper left corner.
-  auto converterNodePos = (sourceNode.pos() + sourceNode.geometry().portScenePosition(sourcePortIndex, sourcePort) 
-    + targetNode.pos() + targetNode.geometry().portScenePosition(targetPortIndex, targetPort)) / 2.0f;
-  converterNodePos.setX(converterNodePos.x() - newNodeGeom.width() / 2.0f);
-  converterNodePos.setY(converterNodePos.y() - newNodeGeom.height() / 2.0f);
-  return converterNodePos;
-}
-
-
 unsigned int
 NodeGeometry::
 portWidth(PortType portType) const
 {
   unsigned width = 0;
 
-  for (auto i = 0ul; i < _nodeIndex.model()->nodePortCount(_nodeIndex, portType); ++i)
+  for (auto const &port : descriptor().ports(portType))
   {
-    QString name = _nodeIndex.model()->nodePortCaption(_nodeIndex, portType, i);
-
-    if (name.isEmpty())
-    {
-      name = _nodeIndex.model()->nodePortDataType(_nodeIndex, portType, i).name;
-    }
-
-    width = std::max(unsigned(_fontMetrics.width(name)),
+    width = std::max(unsigned(_fontMetrics.width(port.label())),
                      width);
   }
 
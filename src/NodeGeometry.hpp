@@ -15,6 +15,7 @@ namespace QtNodes
 {
 
 class NodeGraphicsObject;
+struct NodeDescriptor;
 
 class NODE_EDITOR_PUBLIC NodeGeometry
 {
@@ -72,6 +73,16 @@ public:
   setDraggingPosition(QPointF const& pos)
   { _draggingPos = pos; }
 
+public:
+
+  /// Cached description of the node, fetched from the model on first use
+  NodeDescriptor const&
+  descriptor() const;
+
+  /// Drops the cached descriptor so the next access queries the model again
+  void
+  invalidateDescriptor();
+
 public:
 
   QRectF
@@ -111,12 +122,7 @@ public:
 
   unsigned int
   validationWidth() const;
-  
-  static 
-  QPointF 
-  calculateNodePositionBetweenNodePorts(PortIndex targetPortIndex, PortType targetPort, const NodeGraphicsObject& targetNode, 
-                                      PortIndex sourcePortIndex, PortType sourcePort, const NodeGraphicsObject& sourceNode, 
-                                      const NodeGeometry& newNodeGeom);
+
 private:
 
   unsigned int
@@ -152,6 +158,8 @@ private:
 
   NodeIndex _nodeIndex;
 
+  mutable std::shared_ptr<NodeDescriptor const> _descriptor;
+
   mutable QFontMetrics _fontMetrics;
   mutable QFontMetrics _boldFontMetrics;
 };
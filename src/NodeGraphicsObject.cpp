@@ -18,6 +18,7 @@
 
 #include "NodeIndex.hpp"
 #include "FlowSceneModel.hpp"
+#include "NodeDescriptor.hpp"
 
 namespace QtNodes {
 
@@ -59,6 +60,8 @@ NodeGraphicsObject(FlowScene& scene, const NodeIndex& index)
 
   embedQWidget();
 
+  setDetailLevel(_scene.detailLevel());
+
   // connect to the move signals
   auto onMoveSlot = [this] {
     
@@ -77,8 +80,13 @@ NodeGraphicsObject(FlowScene& scene, const NodeIndex& index)
 
 NodeGraphicsObject::
 ~NodeGraphicsObject() {
+  // the model keeps handing out the widget, the graphics may be created
+  // again around it
   if (_proxyWidget) {
-    delete _proxyWidget->widget();
+    if (auto w = _proxyWidget->widget()) {
+      _proxyWidget->setWidget(nullptr);
+      w->hide();
+    }
   }
 }
 
@@ -231,6 +239,21 @@ void NodeGraphicsObject::lock(bool locked)
 }
 
 
+void
+NodeGraphicsObject::
+setDetailLevel(DetailLevel level)
+{
+  bool const full = level == DetailLevel::Full;
+
+  // an effect renders the item offscreen first, even when barely visible
+  if (auto effect = graphicsEffect())
+    effect->setEnabled(full);
+
+  if (_proxyWidget)
+    _proxyWidget->setVisible(full);
+}
+
+
 void
 NodeGraphicsObject::
 paint(QPainter * painter,
@@ -239,7 +262,7 @@ paint(QPainter * painter,
 {
   painter->setClipRect(option->exposedRect);
 
-  NodePainter::paint(painter, *this);
+  NodePainter::paint(painter, *this, detailLevel(*option, *painter));
 }
 
 
@@ -272,8 +295,6 @@ mousePressEvent(QGraphicsSceneMouseEvent * event)
   auto clickPort =
     [&](PortType portToCheck)
     {
-      auto& model = *_nodeIndex.model();
-      
       // TODO do not pass sceneTransform
       int portIndex = _geometry.checkHitScenePoint(portToCheck,
                                                       event->scenePos(),
@@ -286,7 +307,8 @@ mousePressEvent(QGraphicsSceneMouseEvent * event)
           _state.connections(portToCheck, portIndex);
 
         // start dragging existing connection if it's setup to only have one connection
-        if (!connections.empty() && model.nodePortConnectionPolicy(_nodeIndex, portToCheck, portIndex) == ConnectionPolicy::One)
+        if (!connections.empty() &&
+            _geometry.descriptor().port(portToCheck, portIndex).connectionPolicy == ConnectionPolicy::One)
         {
           auto con = connections[0];
           
@@ -337,7 +359,7 @@ mousePressEvent(QGraphicsSceneMouseEvent * event)
 
   auto pos     = event->pos();
   
-  if (index().model()->nodeResizable(index()) &&
+  if (_geometry.descriptor().resizable &&
     _geometry.resizeRect().contains(QPoint(pos.x(), pos.y())))
   {
     _state.setResizing(true);
@@ -446,7 +468,7 @@ hoverMoveEvent(QGraphicsSceneHoverEvent * event)
 {
   auto pos    = event->pos();
 
-  if (index().model()->nodeResizable(index()) &&
+  if (_geometry.descriptor().resizable &&
     _geometry.resizeRect().contains(QPoint(pos.x(), pos.y())))
   {
     setCursor(QCursor(Qt::SizeFDiagCursor));
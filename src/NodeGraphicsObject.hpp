@@ -7,6 +7,7 @@
 #include "NodeGeometry.hpp"
 #include "NodeIndex.hpp"
 #include "Export.hpp"
+#include "LevelOfDetail.hpp"
 
 class QGraphicsProxyWidget;
 
@@ -75,6 +76,11 @@ public:
   void
   lock(bool locked);
 
+  /// Turns the drop shadow and the embedded widget off below
+  /// `DetailLevel::Full`
+  void
+  setDetailLevel(DetailLevel level);
+
 protected:
   void
   paint(QPainter*                       painter,
@@ -124,7 +130,8 @@ private:
   
   bool _locked;
 
-  // either nullptr or owned by parent QGraphicsItem
+  // either nullptr or owned by parent QGraphicsItem; the embedded widget
+  // is detached on destruction, FlowScene decides when it is deleted
   QGraphicsProxyWidget * _proxyWidget;
 
 };
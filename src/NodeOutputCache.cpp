@@ -0,0 +1,321 @@
+#include "NodeOutputCache.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "DataModelRegistry.hpp"
+#include "NodeDataModel.hpp"
+#include "Node.hpp"
+
+namespace QtNodes {
+
+namespace
+{
+
+constexpr char    Magic[4] = {'Q', 'N', 'O', 'C'};
+constexpr quint16 Version  = 1;
+
+struct CachedPort
+{
+  QString    typeID;
+  QByteArray bytes;
+};
+
+using CachedOutputs = std::vector<CachedPort>;
+
+QDataStream&
+setUp(QDataStream& stream)
+{
+  stream.setByteOrder(QDataStream::LittleEndian);
+  return stream;
+}
+
+
+/// Entries of `cacheFile` by key, empty if it is missing or corrupt
+QHash<QByteArray, CachedOutputs>
+readCache(QString const& cacheFile)
+{
+  QHash<QByteArray, CachedOutputs> entries;
+
+  QFile file(cacheFile);
+  if (!file.open(QIODevice::ReadOnly))
+    return entries;
+
+  QDataStream stream(&file);
+  setUp(stream);
+
+  char magic[sizeof(Magic)];
+  quint16 version;
+  quint32 count;
+
+  if (stream.readRawData(magic, sizeof(magic)) != int(sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), Magic))
+    return entries;
+
+  stream >> version >> count;
+
+  if (version != Version)
+    return entries;
+
+  for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+  {
+    QByteArray key;
+    quint32    ports;
+
+    stream >> key >> ports;
+
+    CachedOutputs outputs;
+
+    for (quint32 port = 0; port < ports && stream.status() == QDataStream::Ok; ++port)
+    {
+      CachedPort cached;
+      stream >> cached.typeID >> cached.bytes;
+      outputs.push_back(std::move(cached));
+    }
+
+    entries[key] = std::move(outputs);
+  }
+
+  // a truncated file is not trusted at all
+  if (stream.status() != QDataStream::Ok)
+  {
+    qWarning() << "Ignoring corrupt node output cache" << cacheFile;
+    entries.clear();
+  }
+
+  return entries;
+}
+
+}
+
+bool
+NodeOutputCache::
+save(DataFlowScene const& scene, QString const& cacheFile)
+{
+  auto* model = static_cast<DataFlowModel*>(scene.model());
+
+  DataModelRegistry const& registry = scene.registry();
+
+  auto const nodeKeys = keys(model->snapshot());
+
+  QByteArray  entries;
+  QDataStream entryStream(&entries, QIODevice::WriteOnly);
+  setUp(entryStream);
+
+  quint32 count = 0;
+
+  for (auto const& key : nodeKeys)
+  {
+    auto iter = model->_nodes.find(key.first);
+    if (iter == model->_nodes.end())
+      continue;
+
+    NodeDataModel* nodeModel = iter->second->nodeDataModel();
+    if (!nodeModel->cacheOutData())
+      continue;
+
+    CachedOutputs outputs;
+    bool serializable = true;
+
+    for (PortIndex port = 0; (unsigned)port < nodeModel->nPorts(PortType::Out); ++port)
+    {
+      auto data = nodeModel->outData(port);
+
+      if (!data)
+      {
+        outputs.push_back(CachedPort{});
+        continue;
+      }
+
+      QString const typeID = data->type().id;
+
+      if (!registry.dataSerializable(typeID))
+      {
+        serializable = false;
+        break;
+      }
+
+      outputs.push_back(CachedPort{typeID, registry.serializeData(*data)});
+    }
+
+    if (!serializable)
+      continue;
+
+    entryStream << key.second << quint32(outputs.size());
+
+    for (auto const& cached : outputs)
+      entryStream << cached.typeID << cached.bytes;
+
+    ++count;
+  }
+
+  QSaveFile file(cacheFile);
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    qWarning() << "Couldn't open file" << cacheFile;
+    return false;
+  }
+
+  QDataStream stream(&file);
+  setUp(stream);
+
+  stream.writeRawData(Magic, sizeof(Magic));
+  stream << Version << count;
+  stream.writeRawData(entries.constData(), entries.size());
+
+  return stream.status() == QDataStream::Ok && file.commit();
+}
+
+
+std::size_t
+NodeOutputCache::
+loadScene(DataFlowScene& scene,
+          QByteArray const& sceneData,
+          QString const& cacheFile)
+{
+  auto* model = static_cast<DataFlowModel*>(scene.model());
+
+  DataModelRegistry const& registry = scene.registry();
+
+  auto const entries = readCache(cacheFile);
+
+  std::size_t restored = 0;
+
+  // restore before the single evaluation at the end of the bulk load, which
+  // then skips the restored nodes
+  model->beginBulkLoad();
+
+  scene.loadFromMemory(sceneData);
+
+  if (!entries.isEmpty())
+  {
+    for (auto const& key : keys(model->snapshot()))
+    {
+      auto entry = entries.find(key.second);
+      if (entry == entries.constEnd())
+        continue;
+
+      auto iter = model->_nodes.find(key.first);
+      if (iter == model->_nodes.end() || !iter->second->nodeDataModel()->cacheOutData())
+        continue;
+
+      std::vector<std::shared_ptr<NodeData>> outputs;
+      bool complete = true;
+
+      for (auto const& cached : entry.value())
+      {
+        if (cached.typeID.isEmpty())
+        {
+          outputs.push_back(nullptr);
+          continue;
+        }
+
+        auto data = registry.deserializeData(cached.typeID, cached.bytes);
+        if (!data)
+        {
+          complete = false;
+          break;
+        }
+
+        outputs.push_back(std::move(data));
+      }
+
+      if (complete && model->restoreOutputs(model->nodeIndex(key.first), outputs))
+        ++restored;
+    }
+  }
+
+  model->endBulkLoad();
+
+  return restored;
+}
+
+
+std::unordered_map<QUuid, QByteArray>
+NodeOutputCache::
+keys(GraphSnapshot const& snapshot)
+{
+  // incoming connections and pending input counts, for Kahn's algorithm
+  std::unordered_map<QUuid, std::vector<ConnectionID>> inputs;
+  std::unordered_map<QUuid, std::vector<QUuid>>        downstream;
+  std::unordered_map<QUuid, std::size_t>               pending;
+
+  snapshot.nodes().forEach([&](QUuid const& id, GraphSnapshot::NodeRecordPtr const&) {
+    pending[id] = 0;
+  });
+
+  snapshot.connections().forEach([&](ConnectionID const& id, NodeDataType const&) {
+    inputs[id.rNodeID].push_back(id);
+    downstream[id.lNodeID].push_back(id.rNodeID);
+    ++pending[id.rNodeID];
+  });
+
+  std::vector<QUuid> ready;
+  for (auto const& p : pending)
+  {
+    if (p.second == 0)
+      ready.push_back(p.first);
+  }
+
+  std::unordered_map<QUuid, QByteArray> result;
+  result.reserve(pending.size());
+
+  while (!ready.empty())
+  {
+    QUuid const id = ready.back();
+    ready.pop_back();
+
+    NodeRecord const* record = snapshot.node(id);
+    Q_ASSERT(record);
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(record->modelName.toUtf8());
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(QJsonDocument(record->modelState).toJson(QJsonDocument::Compact));
+
+    // the order connections are stored in is arbitrary
+    auto& nodeInputs = inputs[id];
+    std::sort(nodeInputs.begin(), nodeInputs.end(),
+              [&result](ConnectionID const& a, ConnectionID const& b) {
+                if (a.rPortID != b.rPortID)
+                  return a.rPortID < b.rPortID;
+                if (a.lPortID != b.lPortID)
+                  return a.lPortID < b.lPortID;
+                return result[a.lNodeID] < result[b.lNodeID];
+              });
+
+    for (ConnectionID const& connection : nodeInputs)
+    {
+      QByteArray input;
+      QDataStream stream(&input, QIODevice::WriteOnly);
+      setUp(stream);
+
+      stream << qint32(connection.rPortID) << qint32(connection.lPortID)
+             << result[connection.lNodeID];
+
+      hash.addData(input);
+    }
+
+    result[id] = hash.result();
+
+    for (QUuid const& next : downstream[id])
+    {
+      if (--pending[next] == 0)
+        ready.push_back(next);
+    }
+  }
+
+  return result;
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include <QtCore/QUuid>
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+
+#include "Export.hpp"
+#include "GraphSnapshot.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+
+/// Persists the outputs of expensive nodes next to a scene, so reopening it
+/// does not recompute them.
+///
+/// Only models that opt in through `NodeDataModel::cacheOutData()` are
+/// cached, and only if each of their outputs is empty or has a serializer
+/// registered with `DataModelRegistry::registerDataSerializer`. Entries are
+/// keyed by a hash of the node's model name and state together with the
+/// keys of everything upstream, so an entry only matches a node computing
+/// from the same inputs; nodes on a cycle are never cached.
+///
+/// The cache file holds, little endian: magic "QNOC", u16 version, u32
+/// entry count, then per entry the key, u32 port count and per port the
+/// data type id and serialized bytes (empty id for no data), each as a
+/// QDataStream QByteArray or QString.
+class NODE_EDITOR_PUBLIC NodeOutputCache
+{
+public:
+
+  /// Writes the outputs of the cacheable nodes of `scene` to `cacheFile`
+  static bool
+  save(DataFlowScene const& scene, QString const& cacheFile);
+
+  /// Loads `sceneData` like `DataFlowScene::loadFromMemory` and gives the
+  /// nodes found in `cacheFile` their cached outputs instead of evaluating
+  /// them; their inputs are only delivered once one changes. Returns the
+  /// number of nodes restored. A missing or stale cache only means nodes
+  /// are evaluated as usual.
+  static std::size_t
+  loadScene(DataFlowScene& scene,
+            QByteArray const& sceneData,
+            QString const& cacheFile);
+
+  /// Cache keys of the nodes of `snapshot`, nodes on a cycle have none
+  static std::unordered_map<QUuid, QByteArray>
+  keys(GraphSnapshot const& snapshot);
+};
+}
@@ -11,6 +11,7 @@
 #include "NodeState.hpp"
 #include "NodeIndex.hpp"
 #include "FlowSceneModel.hpp"
+#include "NodeDescriptor.hpp"
 #include "NodePainterDelegate.hpp"
 #include "FlowScene.hpp"
 
@@ -19,7 +20,8 @@ namespace QtNodes {
 void
 NodePainter::
 paint(QPainter* painter,
-      NodeGraphicsObject const & graphicsObject)
+      NodeGraphicsObject const & graphicsObject,
+      DetailLevel level)
 {
   NodeGeometry const& geom = graphicsObject.geometry();
 
@@ -27,6 +29,23 @@ paint(QPainter* painter,
 
   //--------------------------------------------
 
+  if (level == DetailLevel::Minimal)
+  {
+    drawMinimalRect(painter, graphicsObject);
+    return;
+  }
+
+  if (level == DetailLevel::Simplified)
+  {
+    // text and unconnected ports are unreadable at this size
+    drawNodeRect(painter, graphicsObject, true);
+
+    drawFilledConnectionPoints(painter, graphicsObject);
+
+    drawValidationRect(painter, graphicsObject, false);
+    return;
+  }
+
   drawNodeRect(painter, graphicsObject);
 
   drawConnectionPoints(painter, graphicsObject);
@@ -51,12 +70,10 @@ paint(QPainter* painter,
 
 void
 NodePainter::
-drawNodeRect(QPainter* painter, NodeGraphicsObject const & graphicsObject)
+drawNodeRect(QPainter* painter, NodeGraphicsObject const & graphicsObject, bool flat)
 {
-  FlowSceneModel& model = *graphicsObject.flowScene().model();
-  
-  NodeStyle const& nodeStyle = model.nodeStyle(graphicsObject.index());
   NodeGeometry const& nodeGeometry = graphicsObject.geometry();
+  NodeStyle const& nodeStyle = nodeGeometry.descriptor().style;
 
   auto color = graphicsObject.isSelected()
                ? nodeStyle.SelectedBoundaryColor
@@ -73,15 +90,22 @@ drawNodeRect(QPainter* painter, NodeGraphicsObject const & graphicsObject)
     painter->setPen(p);
   }
 
-  QLinearGradient gradient(QPointF(0.0, 0.0),
-                           QPointF(2.0, nodeGeometry.height()));
+  if (flat)
+  {
+    painter->setBrush(nodeStyle.GradientColor1);
+  }
+  else
+  {
+    QLinearGradient gradient(QPointF(0.0, 0.0),
+                             QPointF(2.0, nodeGeometry.height()));
 
-  gradient.setColorAt(0.0, nodeStyle.GradientColor0);
-  gradient.setColorAt(0.03, nodeStyle.GradientColor1);
-  gradient.setColorAt(0.97, nodeStyle.GradientColor2);
-  gradient.setColorAt(1.0, nodeStyle.GradientColor3);
+    gradient.setColorAt(0.0, nodeStyle.GradientColor0);
+    gradient.setColorAt(0.03, nodeStyle.GradientColor1);
+    gradient.setColorAt(0.97, nodeStyle.GradientColor2);
+    gradient.setColorAt(1.0, nodeStyle.GradientColor3);
 
-  painter->setBrush(gradient);
+    painter->setBrush(gradient);
+  }
 
   float diam = nodeStyle.ConnectionPointDiameter;
 
@@ -93,6 +117,27 @@ drawNodeRect(QPainter* painter, NodeGraphicsObject const & graphicsObject)
 }
 
 
+void
+NodePainter::
+drawMinimalRect(QPainter* painter, NodeGraphicsObject const & graphicsObject)
+{
+  NodeGeometry const& nodeGeometry = graphicsObject.geometry();
+  NodeStyle const& nodeStyle = nodeGeometry.descriptor().style;
+
+  // the boundary color shows selection and validation at a glance
+  QColor color = nodeStyle.GradientColor1;
+
+  if (graphicsObject.isSelected())
+    color = nodeStyle.SelectedBoundaryColor;
+  else if (nodeGeometry.descriptor().validationState == NodeValidationState::Error)
+    color = nodeStyle.ErrorColor;
+  else if (nodeGeometry.descriptor().validationState == NodeValidationState::Warning)
+    color = nodeStyle.WarningColor;
+
+  painter->fillRect(QRectF(0.0, 0.0, nodeGeometry.width(), nodeGeometry.height()), color);
+}
+
+
 void
 NodePainter::
 drawConnectionPoints(QPainter* painter, NodeGraphicsObject const & graphicsObject)
@@ -101,7 +146,8 @@ drawConnectionPoints(QPainter* painter, NodeGraphicsObject const & graphicsObjec
   NodeState const& nodeState       = graphicsObject.nodeState();
   NodeGeometry const& nodeGeometry = graphicsObject.geometry();
   const FlowSceneModel& model      = *graphicsObject.flowScene().model();
-  NodeStyle const& nodeStyle       = model.nodeStyle(graphicsObject.index());
+  NodeDescriptor const& descriptor = nodeGeometry.descriptor();
+  NodeStyle const& nodeStyle       = descriptor.style;
 
   float diameter = nodeStyle.ConnectionPointDiameter;
   auto  reducedDiameter = diameter * 0.6;
@@ -116,10 +162,11 @@ drawConnectionPoints(QPainter* painter, NodeGraphicsObject const & graphicsObjec
 
         QPointF p = nodeGeometry.portScenePosition(i, portType);
 
-        auto const & dataType = model.nodePortDataType(graphicsObject.index(), portType, i);
+        auto const & port     = descriptor.port(portType, i);
+        auto const & dataType = port.dataType;
 
         bool canConnect = (nodeState.getEntries(portType)[i].empty() ||
-                            model.nodePortConnectionPolicy(graphicsObject.index(), portType, i) == ConnectionPolicy::Many);
+                            port.connectionPolicy == ConnectionPolicy::Many);
 
         double r = 1.0;
         if (nodeState.isReacting() &&
@@ -131,14 +178,15 @@ drawConnectionPoints(QPainter* painter, NodeGraphicsObject const & graphicsObjec
           double dist = std::sqrt(QPointF::dotProduct(diff, diff));
           bool   typeConvertable = false;
 
+          if (nodeState.reactingDataType().id != dataType.id)
           {
             if (portType == PortType::In)
             {
-              typeConvertable = model.converterNode(nodeState.reactingDataType(), dataType) != "";
+              typeConvertable = model.typesConvertible(nodeState.reactingDataType(), dataType);
             }
             else
             {
-              typeConvertable = model.converterNode(dataType, nodeState.reactingDataType()) != "";
+              typeConvertable = model.typesConvertible(dataType, nodeState.reactingDataType());
             }
           }
 
@@ -185,8 +233,8 @@ drawFilledConnectionPoints(QPainter * painter, NodeGraphicsObject const & graphi
   auto const& connectionStyle = StyleCollection::connectionStyle();
   NodeState const& state      = graphicsObject.nodeState();
   NodeGeometry const& geom    = graphicsObject.geometry();
-  FlowSceneModel const& model = *graphicsObject.index().model();
-  NodeStyle const& nodeStyle  = model.nodeStyle(graphicsObject.index());
+  NodeDescriptor const& descriptor = geom.descriptor();
+  NodeStyle const& nodeStyle  = descriptor.style;
 
   auto diameter = nodeStyle.ConnectionPointDiameter;
 
@@ -201,7 +249,7 @@ drawFilledConnectionPoints(QPainter * painter, NodeGraphicsObject const & graphi
 
         if (!state.getEntries(portType)[i].empty())
         {
-          auto const & dataType = model.nodePortDataType(graphicsObject.index(), portType, i);
+          auto const & dataType = descriptor.port(portType, i).dataType;
 
           if (connectionStyle.useDataDefinedColors())
           {
@@ -231,11 +279,10 @@ void
 NodePainter::
 drawModelName(QPainter * painter, NodeGraphicsObject const & graphicsObject)
 {
-  NodeStyle const& nodeStyle = graphicsObject.index().model()->nodeStyle(graphicsObject.index());
-  FlowSceneModel const& model = *graphicsObject.index().model();
   NodeGeometry const& geom = graphicsObject.geometry();
+  NodeStyle const& nodeStyle = geom.descriptor().style;
 
-  QString const &name = model.nodeCaption(graphicsObject.index());
+  QString const &name = geom.descriptor().caption;
   
   if (name.isEmpty()) {
     return;
@@ -267,14 +314,14 @@ drawEntryLabels(QPainter * painter, NodeGraphicsObject const & graphicsObject)
 {
   NodeState const& state = graphicsObject.nodeState();
   NodeGeometry const& geom = graphicsObject.geometry();
-  FlowSceneModel const& model = *graphicsObject.index().model();
+  NodeDescriptor const& descriptor = geom.descriptor();
   QFontMetrics const & metrics =
     painter->fontMetrics();
 
   auto drawPoints =
     [&](PortType portType)
     {
-      auto const &nodeStyle = graphicsObject.index().model()->nodeStyle(graphicsObject.index());
+      auto const &nodeStyle = descriptor.style;
 
       auto& entries = state.getEntries(portType);
 
@@ -289,12 +336,7 @@ drawEntryLabels(QPainter * painter, NodeGraphicsObject const & graphicsObject)
         else
           painter->setPen(nodeStyle.FontColor);
 
-        QString s = model.nodePortCaption(graphicsObject.index(), portType, i);
-
-        if (s.isEmpty())
-        {
-          s = model.nodePortDataType(graphicsObject.index(), portType, i).name;
-        }
+        QString const &s = descriptor.port(portType, i).label();
 
         auto rect = metrics.boundingRect(s);
 
@@ -329,9 +371,7 @@ NodePainter::
 drawResizeRect(QPainter * painter,
                      NodeGraphicsObject const & graphicsObject)
 {
-  FlowSceneModel const& model = *graphicsObject.index().model();
-
-  if (model.nodeResizable(graphicsObject.index()))
+  if (graphicsObject.geometry().descriptor().resizable)
   {
     painter->setBrush(Qt::gray);
 
@@ -342,16 +382,16 @@ drawResizeRect(QPainter * painter,
 
 void
 NodePainter::
-drawValidationRect(QPainter * painter, NodeGraphicsObject const & graphicsObject)
+drawValidationRect(QPainter * painter, NodeGraphicsObject const & graphicsObject, bool withMessage)
 {
-  FlowSceneModel const& model = *graphicsObject.index().model();
   NodeGeometry const& geom = graphicsObject.geometry();
+  NodeDescriptor const& descriptor = geom.descriptor();
 
-  auto modelValidationState = model.nodeValidationState(graphicsObject.index());
+  auto modelValidationState = descriptor.validationState;
 
   if (modelValidationState != NodeValidationState::Valid)
   {
-    NodeStyle const& nodeStyle = model.nodeStyle(graphicsObject.index());
+    NodeStyle const& nodeStyle = descriptor.style;
 
     auto color = graphicsObject.isSelected()
                  ? nodeStyle.SelectedBoundaryColor
@@ -389,10 +429,13 @@ drawValidationRect(QPainter * painter, NodeGraphicsObject const & graphicsObject
 
     painter->drawRoundedRect(boundary, radius, radius);
 
+    if (!withMessage)
+      return;
+
     painter->setBrush(Qt::gray);
 
     //Drawing the validation message itself
-    QString const &errorMsg = model.nodeValidationMessage(graphicsObject.index());
+    QString const &errorMsg = descriptor.validationMessage;
 
     QFont f = painter->font();
 
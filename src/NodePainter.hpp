@@ -4,6 +4,8 @@
 
 #include <QtGui/QPainter>
 
+#include "LevelOfDetail.hpp"
+
 namespace QtNodes
 {
 
@@ -24,12 +26,21 @@ public:
   static
   void
   paint(QPainter* painter,
-        NodeGraphicsObject const & graphicsObject);
+        NodeGraphicsObject const & graphicsObject,
+        DetailLevel level = DetailLevel::Full);
 
+  /// `flat` fills with one color instead of the gradient
   static
   void
   drawNodeRect(QPainter* painter,
-               NodeGraphicsObject const & graphicsObject);
+               NodeGraphicsObject const & graphicsObject,
+               bool flat = false);
+
+  /// The node as a filled rectangle, for nodes a few pixels large
+  static
+  void
+  drawMinimalRect(QPainter* painter,
+                  NodeGraphicsObject const & graphicsObject);
 
   static
   void
@@ -55,9 +66,11 @@ public:
   drawResizeRect(QPainter* painter,
                  NodeGraphicsObject const & graphicsObject);
 
+  /// Without `withMessage` only the colored background is drawn
   static
   void
   drawValidationRect(QPainter * painter,
-                     NodeGraphicsObject const & graphicsObject);
+                     NodeGraphicsObject const & graphicsObject,
+                     bool withMessage = true);
 };
 }
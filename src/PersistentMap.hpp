@@ -0,0 +1,526 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace QtNodes
+{
+
+/// Immutable hash map with structural sharing (a hash array mapped trie).
+///
+/// `insert` and `erase` return a new map and leave the original untouched;
+/// both share every trie node that the operation did not touch, so an
+/// update costs O(log32 n) new nodes and copying a map is O(1).
+/// Instances are safe to read from several threads at once.
+template<typename Key,
+         typename Value,
+         typename Hash  = std::hash<Key>,
+         typename Equal = std::equal_to<Key> >
+class PersistentMap
+{
+public:
+
+  struct Entry
+  {
+    Key   key;
+    Value value;
+  };
+
+private:
+
+  struct TrieNode;
+
+  using NodePtr = std::shared_ptr<TrieNode const>;
+
+  struct TrieNode
+  {
+    // bit i set: slot i holds an entry / a child, stored densely in slot order
+    std::uint32_t dataMap = 0;
+    std::uint32_t nodeMap = 0;
+
+    std::vector<Entry>   entries;
+    std::vector<NodePtr> children;
+
+    // set once the hash bits are exhausted, entries are then searched linearly
+    bool collision = false;
+  };
+
+  static constexpr unsigned BitsPerLevel = 5;
+  static constexpr unsigned HashBits     = sizeof(std::size_t) * 8;
+
+public:
+
+  PersistentMap() = default;
+
+  std::size_t
+  size() const { return _size; }
+
+  bool
+  empty() const { return _size == 0; }
+
+  /// Returns nullptr if the key is not present
+  Value const*
+  find(Key const& key) const
+  {
+    std::size_t const hash = Hash()(key);
+
+    TrieNode const* node = _root.get();
+
+    for (unsigned shift = 0; node != nullptr; shift += BitsPerLevel)
+    {
+      if (node->collision)
+      {
+        for (auto const& e : node->entries)
+        {
+          if (Equal()(e.key, key))
+            return &e.value;
+        }
+        return nullptr;
+      }
+
+      std::uint32_t const bit = slotBit(hash, shift);
+
+      if (node->dataMap & bit)
+      {
+        auto const& e = node->entries[index(node->dataMap, bit)];
+
+        return Equal()(e.key, key) ? &e.value : nullptr;
+      }
+
+      if (!(node->nodeMap & bit))
+        return nullptr;
+
+      node = node->children[index(node->nodeMap, bit)].get();
+    }
+
+    return nullptr;
+  }
+
+  bool
+  contains(Key const& key) const { return find(key) != nullptr; }
+
+  /// New map with `key` set to `value`
+  PersistentMap
+  insert(Key const& key, Value value) const
+  {
+    bool added = false;
+
+    PersistentMap result;
+    result._root = insert(_root, Entry{key, std::move(value)}, Hash()(key), 0, added);
+    result._size = _size + (added ? 1 : 0);
+
+    return result;
+  }
+
+  /// New map without `key`; shares everything with this map if the key is absent
+  PersistentMap
+  erase(Key const& key) const
+  {
+    bool removed = false;
+
+    PersistentMap result;
+    result._root = erase(_root, key, Hash()(key), 0, removed);
+    result._size = _size - (removed ? 1 : 0);
+
+    return result;
+  }
+
+  /// Calls `visitor(key, value)` for every entry, in unspecified order
+  template<typename Visitor>
+  void
+  forEach(Visitor&& visitor) const
+  {
+    forEach(_root.get(), visitor);
+  }
+
+  /// True if both maps are the same version (not just equal content)
+  bool
+  sharesRootWith(PersistentMap const& other) const
+  { return _root == other._root; }
+
+  /// Compares with `other` by walking both tries side by side, skipping
+  /// the subtrees they share, so maps derived from one another compare in
+  /// proportion to their differences. Calls `removed(key, value)` for keys
+  /// only in this map, `added(key, value)` for keys only in `other`, and
+  /// `common(key, value, otherValue)` for keys in both that lie outside the
+  /// shared subtrees, whose values may or may not differ.
+  template<typename Removed, typename Added, typename Common>
+  void
+  diff(PersistentMap const& other,
+       Removed&& removed, Added&& added, Common&& common) const
+  {
+    diff(_root.get(), other._root.get(), removed, added, common);
+  }
+
+private:
+
+  static std::uint32_t
+  slotBit(std::size_t hash, unsigned shift)
+  {
+    return std::uint32_t(1) << ((hash >> shift) & 0x1f);
+  }
+
+  static std::size_t
+  index(std::uint32_t bitmap, std::uint32_t bit)
+  {
+    return popcount(bitmap & (bit - 1));
+  }
+
+  static std::size_t
+  popcount(std::uint32_t x)
+  {
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (((x + (x >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+  }
+
+  static NodePtr
+  merge(Entry a, std::size_t hashA,
+        Entry b, std::size_t hashB,
+        unsigned shift)
+  {
+    auto node = std::make_shared<TrieNode>();
+
+    if (shift >= HashBits)
+    {
+      node->collision = true;
+      node->entries.push_back(std::move(a));
+      node->entries.push_back(std::move(b));
+      return node;
+    }
+
+    std::uint32_t const bitA = slotBit(hashA, shift);
+    std::uint32_t const bitB = slotBit(hashB, shift);
+
+    if (bitA == bitB)
+    {
+      node->nodeMap = bitA;
+      node->children.push_back(merge(std::move(a), hashA,
+                                     std::move(b), hashB,
+                                     shift + BitsPerLevel));
+      return node;
+    }
+
+    node->dataMap = bitA | bitB;
+
+    if (bitA < bitB)
+    {
+      node->entries.push_back(std::move(a));
+      node->entries.push_back(std::move(b));
+    }
+    else
+    {
+      node->entries.push_back(std::move(b));
+      node->entries.push_back(std::move(a));
+    }
+
+    return node;
+  }
+
+  static NodePtr
+  insert(NodePtr const& node, Entry entry, std::size_t hash, unsigned shift, bool& added)
+  {
+    if (!node)
+    {
+      added = true;
+
+      auto leaf = std::make_shared<TrieNode>();
+      if (shift >= HashBits)
+      {
+        leaf->collision = true;
+      }
+      else
+      {
+        leaf->dataMap = slotBit(hash, shift);
+      }
+      leaf->entries.push_back(std::move(entry));
+      return leaf;
+    }
+
+    auto copy = std::make_shared<TrieNode>(*node);
+
+    if (node->collision)
+    {
+      for (auto& e : copy->entries)
+      {
+        if (Equal()(e.key, entry.key))
+        {
+          e.value = std::move(entry.value);
+          return copy;
+        }
+      }
+
+      added = true;
+      copy->entries.push_back(std::move(entry));
+      return copy;
+    }
+
+    std::uint32_t const bit = slotBit(hash, shift);
+
+    if (node->dataMap & bit)
+    {
+      auto const dataIdx = index(node->dataMap, bit);
+      auto& existing     = copy->entries[dataIdx];
+
+      if (Equal()(existing.key, entry.key))
+      {
+        existing.value = std::move(entry.value);
+        return copy;
+      }
+
+      // two keys in one slot: push both one level down
+      added = true;
+
+      std::size_t const existingHash = Hash()(existing.key);
+
+      NodePtr child = merge(std::move(existing), existingHash,
+                            std::move(entry), hash,
+                            shift + BitsPerLevel);
+
+      copy->entries.erase(copy->entries.begin() + dataIdx);
+      copy->dataMap &= ~bit;
+
+      copy->nodeMap |= bit;
+      copy->children.insert(copy->children.begin() + index(copy->nodeMap, bit),
+                            std::move(child));
+      return copy;
+    }
+
+    if (node->nodeMap & bit)
+    {
+      auto const childIdx = index(node->nodeMap, bit);
+
+      copy->children[childIdx] = insert(node->children[childIdx],
+                                        std::move(entry), hash,
+                                        shift + BitsPerLevel, added);
+      return copy;
+    }
+
+    added = true;
+
+    copy->dataMap |= bit;
+    copy->entries.insert(copy->entries.begin() + index(copy->dataMap, bit),
+                         std::move(entry));
+    return copy;
+  }
+
+  static NodePtr
+  erase(NodePtr const& node, Key const& key, std::size_t hash, unsigned shift, bool& removed)
+  {
+    if (!node)
+      return node;
+
+    if (node->collision)
+    {
+      for (std::size_t i = 0; i < node->entries.size(); ++i)
+      {
+        if (Equal()(node->entries[i].key, key))
+        {
+          removed = true;
+
+          if (node->entries.size() == 1)
+            return nullptr;
+
+          auto copy = std::make_shared<TrieNode>(*node);
+          copy->entries.erase(copy->entries.begin() + i);
+          return copy;
+        }
+      }
+      return node;
+    }
+
+    std::uint32_t const bit = slotBit(hash, shift);
+
+    if (node->dataMap & bit)
+    {
+      auto const dataIdx = index(node->dataMap, bit);
+
+      if (!Equal()(node->entries[dataIdx].key, key))
+        return node;
+
+      removed = true;
+
+      if (node->entries.size() == 1 && node->children.empty())
+        return nullptr;
+
+      auto copy = std::make_shared<TrieNode>(*node);
+      copy->entries.erase(copy->entries.begin() + dataIdx);
+      copy->dataMap &= ~bit;
+      return copy;
+    }
+
+    if (node->nodeMap & bit)
+    {
+      auto const childIdx = index(node->nodeMap, bit);
+      auto const& child   = node->children[childIdx];
+
+      NodePtr newChild = erase(child, key, hash, shift + BitsPerLevel, removed);
+
+      if (newChild == child)
+        return node;
+
+      auto copy = std::make_shared<TrieNode>(*node);
+
+      if (newChild && (newChild->children.size() > 0 || newChild->entries.size() > 1))
+      {
+        copy->children[childIdx] = std::move(newChild);
+        return copy;
+      }
+
+      // the child is empty or holds a single entry: inline it into this node
+      copy->children.erase(copy->children.begin() + childIdx);
+      copy->nodeMap &= ~bit;
+
+      if (newChild)
+      {
+        copy->dataMap |= bit;
+        copy->entries.insert(copy->entries.begin() + index(copy->dataMap, bit),
+                             newChild->entries.front());
+      }
+
+      if (copy->entries.empty() && copy->children.empty())
+        return nullptr;
+
+      return copy;
+    }
+
+    return node;
+  }
+
+  template<typename Visitor>
+  static void
+  forEach(TrieNode const* node, Visitor& visitor)
+  {
+    if (!node)
+      return;
+
+    for (auto const& e : node->entries)
+      visitor(e.key, e.value);
+
+    for (auto const& child : node->children)
+      forEach(child.get(), visitor);
+  }
+
+  /// Compares an entry of one map with the subtree of the other in its slot
+  template<typename Visitor, typename Missing, typename Common>
+  static void
+  diffEntry(Entry const& entry, TrieNode const* subtree, bool entryIsMine,
+            Visitor& visitor, Missing& missing, Common& common)
+  {
+    bool found = false;
+
+    auto compare = [&](Key const& key, Value const& value) {
+      if (!found && Equal()(key, entry.key))
+      {
+        found = true;
+
+        if (entryIsMine)
+          common(key, entry.value, value);
+        else
+          common(key, value, entry.value);
+      }
+      else
+      {
+        visitor(key, value);
+      }
+    };
+
+    forEach(subtree, compare);
+
+    if (!found)
+      missing(entry.key, entry.value);
+  }
+
+  template<typename Removed, typename Added, typename Common>
+  static void
+  diff(TrieNode const* mine, TrieNode const* theirs,
+       Removed& removed, Added& added, Common& common)
+  {
+    if (mine == theirs)
+      return;
+
+    if (!mine)
+    {
+      forEach(theirs, added);
+      return;
+    }
+
+    if (!theirs)
+    {
+      forEach(mine, removed);
+      return;
+    }
+
+    // only the last level holds collision nodes, both sides are then
+    // small unordered lists
+    if (mine->collision || theirs->collision)
+    {
+      for (auto const& e : mine->entries)
+      {
+        auto match = std::find_if(theirs->entries.begin(), theirs->entries.end(),
+                                  [&e](Entry const& t) { return Equal()(t.key, e.key); });
+
+        if (match == theirs->entries.end())
+          removed(e.key, e.value);
+        else
+          common(e.key, e.value, match->value);
+      }
+
+      for (auto const& t : theirs->entries)
+      {
+        bool const known = std::any_of(mine->entries.begin(), mine->entries.end(),
+                                       [&t](Entry const& e) { return Equal()(t.key, e.key); });
+        if (!known)
+          added(t.key, t.value);
+      }
+      return;
+    }
+
+    for (unsigned slot = 0; slot < 32; ++slot)
+    {
+      std::uint32_t const bit = std::uint32_t(1) << slot;
+
+      Entry const*    myEntry    = (mine->dataMap & bit) ? &mine->entries[index(mine->dataMap, bit)] : nullptr;
+      Entry const*    theirEntry = (theirs->dataMap & bit) ? &theirs->entries[index(theirs->dataMap, bit)] : nullptr;
+      TrieNode const* myChild    = (mine->nodeMap & bit) ? mine->children[index(mine->nodeMap, bit)].get() : nullptr;
+      TrieNode const* theirChild = (theirs->nodeMap & bit) ? theirs->children[index(theirs->nodeMap, bit)].get() : nullptr;
+
+      if (myEntry && theirEntry)
+      {
+        if (Equal()(myEntry->key, theirEntry->key))
+        {
+          common(myEntry->key, myEntry->value, theirEntry->value);
+        }
+        else
+        {
+          removed(myEntry->key, myEntry->value);
+          added(theirEntry->key, theirEntry->value);
+        }
+      }
+      else if (myEntry)
+      {
+        diffEntry(*myEntry, theirChild, true, added, removed, common);
+      }
+      else if (theirEntry)
+      {
+        diffEntry(*theirEntry, myChild, false, removed, added, common);
+      }
+      else
+      {
+        diff(myChild, theirChild, removed, added, common);
+      }
+    }
+  }
+
+private:
+
+  NodePtr     _root;
+  std::size_t _size = 0;
+};
+
+} // namespace QtNodes
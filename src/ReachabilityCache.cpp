@@ -0,0 +1,252 @@
+#include "ReachabilityCache.hpp"
+
+#include <algorithm>
+
+namespace QtNodes {
+
+std::vector<QUuid>
+ReachabilityCache::
+descendants(QUuid const& id) const
+{
+  return collect(id, Down);
+}
+
+
+std::vector<QUuid>
+ReachabilityCache::
+ancestors(QUuid const& id) const
+{
+  return collect(id, Up);
+}
+
+
+bool
+ReachabilityCache::
+reaches(QUuid const& upstream, QUuid const& downstream) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto from = _slots.find(upstream);
+  auto to   = _slots.find(downstream);
+
+  if (from == _slots.end() || to == _slots.end())
+    return false;
+
+  return test(reachable(from->second, Down), to->second);
+}
+
+
+void
+ReachabilityCache::
+nodeAdded(QUuid const& id)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  Slot slot;
+
+  if (!_freeSlots.empty())
+  {
+    slot = _freeSlots.back();
+    _freeSlots.pop_back();
+  }
+  else
+  {
+    slot = static_cast<Slot>(_entries.size());
+    _entries.emplace_back();
+  }
+
+  _entries[slot].id = id;
+
+  _slots[id] = slot;
+}
+
+
+void
+ReachabilityCache::
+nodeRemoved(QUuid const& id)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  auto iter = _slots.find(id);
+  if (iter == _slots.end())
+    return;
+
+  Slot const slot = iter->second;
+  _slots.erase(iter);
+
+  // without edges the node is in no other node's cached sets,
+  // so the slot can be reused right away
+  auto& entry = _entries[slot];
+  Q_ASSERT(entry.successors.empty() && entry.predecessors.empty());
+
+  for (Direction direction : {Down, Up})
+  {
+    if (entry.cached[direction])
+    {
+      auto& cached = _cachedSlots[direction];
+      cached.erase(std::find(cached.begin(), cached.end(), slot));
+    }
+  }
+
+  entry = Entry();
+  _freeSlots.push_back(slot);
+}
+
+
+void
+ReachabilityCache::
+edgeAdded(QUuid const& from, QUuid const& to)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  Slot const u = _slots.at(from);
+  Slot const v = _slots.at(to);
+
+  invalidate(u, Down);
+  invalidate(v, Up);
+
+  _entries[u].successors.push_back(v);
+  _entries[v].predecessors.push_back(u);
+}
+
+
+void
+ReachabilityCache::
+edgeRemoved(QUuid const& from, QUuid const& to)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  Slot const u = _slots.at(from);
+  Slot const v = _slots.at(to);
+
+  invalidate(u, Down);
+  invalidate(v, Up);
+
+  auto eraseOne = [](std::vector<Slot>& slots, Slot slot) {
+    auto iter = std::find(slots.begin(), slots.end(), slot);
+    Q_ASSERT(iter != slots.end());
+    slots.erase(iter);
+  };
+  eraseOne(_entries[u].successors, v);
+  eraseOne(_entries[v].predecessors, u);
+}
+
+
+bool
+ReachabilityCache::
+test(Bitset const& bits, Slot slot)
+{
+  std::size_t const word = slot / 64;
+
+  return word < bits.size() && (bits[word] >> (slot % 64)) & 1u;
+}
+
+
+ReachabilityCache::Bitset const&
+ReachabilityCache::
+reachable(Slot slot, Direction direction) const
+{
+  auto& entry = _entries[slot];
+
+  if (entry.cached[direction])
+    return entry.reachable[direction];
+
+  Bitset bits((_entries.size() + 63) / 64, 0);
+
+  std::vector<Slot> stack;
+
+  auto const& start = direction == Down ? entry.successors : entry.predecessors;
+  stack.assign(start.begin(), start.end());
+
+  while (!stack.empty())
+  {
+    Slot const current = stack.back();
+    stack.pop_back();
+
+    if (test(bits, current))
+      continue;
+
+    bits[current / 64] |= std::uint64_t(1) << (current % 64);
+
+    // reuse what is already known downstream of here
+    auto const& next = _entries[current];
+    if (next.cached[direction])
+    {
+      auto const& known = next.reachable[direction];
+      for (std::size_t w = 0; w < known.size(); ++w)
+        bits[w] |= known[w];
+      continue;
+    }
+
+    auto const& neighbours = direction == Down ? next.successors : next.predecessors;
+    stack.insert(stack.end(), neighbours.begin(), neighbours.end());
+  }
+
+  entry.reachable[direction] = std::move(bits);
+  entry.cached[direction]    = true;
+
+  _cachedSlots[direction].push_back(slot);
+
+  return entry.reachable[direction];
+}
+
+
+std::vector<QUuid>
+ReachabilityCache::
+collect(QUuid const& id, Direction direction) const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  std::vector<QUuid> ret;
+
+  auto iter = _slots.find(id);
+  if (iter == _slots.end())
+    return ret;
+
+  Bitset const& bits = reachable(iter->second, direction);
+
+  for (std::size_t w = 0; w < bits.size(); ++w)
+  {
+    for (std::uint64_t word = bits[w]; word != 0; word &= word - 1)
+    {
+      std::size_t bit = 0;
+      while (!((word >> bit) & 1u))
+        ++bit;
+
+      ret.push_back(_entries[w * 64 + bit].id);
+    }
+  }
+
+  return ret;
+}
+
+
+void
+ReachabilityCache::
+invalidate(Slot slot, Direction direction)
+{
+  // an edge change at `slot` affects the sets of `slot` and of every node
+  // whose set (in the same direction) contains `slot`
+  auto& cached = _cachedSlots[direction];
+
+  for (std::size_t i = 0; i < cached.size(); )
+  {
+    Slot const s = cached[i];
+    auto& entry  = _entries[s];
+
+    if (s == slot || test(entry.reachable[direction], slot))
+    {
+      entry.cached[direction] = false;
+      entry.reachable[direction].clear();
+
+      cached[i] = cached.back();
+      cached.pop_back();
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
+} // namespace QtNodes
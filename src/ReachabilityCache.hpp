@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include <QtCore/QUuid>
+
+#include "Export.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+/// Answers "which nodes are downstream / upstream of this one" for a graph
+/// that changes edge by edge.
+///
+/// Nodes get dense slots; the descendant and ancestor sets of a node are
+/// computed on first request as bitsets over the slots and cached. Adding
+/// or removing an edge u -> v only drops the cached sets that can change:
+/// descendants of u and of every node upstream of u, ancestors of v and of
+/// every node downstream of v. Queries lock internally and may come from
+/// any thread that holds the model's graph lock for reading.
+class NODE_EDITOR_PUBLIC ReachabilityCache
+{
+public:
+
+  /// Nodes reachable from `id` by following connections downstream,
+  /// excluding `id` itself unless it lies on a cycle
+  std::vector<QUuid>
+  descendants(QUuid const& id) const;
+
+  /// Nodes from which `id` can be reached
+  std::vector<QUuid>
+  ancestors(QUuid const& id) const;
+
+  /// True if data leaving `upstream` can arrive at `downstream`
+  bool
+  reaches(QUuid const& upstream, QUuid const& downstream) const;
+
+public: // maintenance, called by the model
+
+  void
+  nodeAdded(QUuid const& id);
+
+  /// The node must not have any edges left
+  void
+  nodeRemoved(QUuid const& id);
+
+  void
+  edgeAdded(QUuid const& from, QUuid const& to);
+
+  void
+  edgeRemoved(QUuid const& from, QUuid const& to);
+
+private:
+
+  using Slot   = std::uint32_t;
+  using Bitset = std::vector<std::uint64_t>;
+
+  enum Direction { Down = 0, Up = 1 };
+
+  struct Entry
+  {
+    QUuid id;
+
+    // adjacency; an entry appears once per connection
+    std::vector<Slot> successors;
+    std::vector<Slot> predecessors;
+
+    bool   cached[2] = {false, false};
+    Bitset reachable[2];
+  };
+
+  static bool
+  test(Bitset const& bits, Slot slot);
+
+  Bitset const&
+  reachable(Slot slot, Direction direction) const;
+
+  std::vector<QUuid>
+  collect(QUuid const& id, Direction direction) const;
+
+  void
+  invalidate(Slot slot, Direction direction);
+
+private:
+
+  mutable std::mutex _mutex;
+
+  mutable std::vector<Entry> _entries;
+
+  // slots with a cached set, per direction, so invalidation only visits
+  // those and costs nothing while no queries are made
+  mutable std::vector<Slot> _cachedSlots[2];
+
+  std::vector<Slot> _freeSlots;
+
+  std::unordered_map<QUuid, Slot> _slots;
+};
+
+} // namespace QtNodes
@@ -0,0 +1,288 @@
+#include "SceneDiff.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "NodeDataModel.hpp"
+#include "Node.hpp"
+
+namespace QtNodes {
+
+namespace
+{
+
+using NodeRecordPtr = GraphSnapshot::NodeRecordPtr;
+
+bool
+sameState(NodeRecord const& a, NodeRecord const& b)
+{
+  return a.modelName == b.modelName && a.modelState == b.modelState;
+}
+
+}
+
+SceneDiff::
+SceneDiff(GraphSnapshot const& from, GraphSnapshot const& to)
+  : _to(to)
+{
+  from.nodes().diff(to.nodes(),
+    [this](QUuid const&, NodeRecordPtr const& record) {
+      _removedNodes.push_back(record);
+    },
+    [this](QUuid const&, NodeRecordPtr const& record) {
+      _addedNodes.push_back(record);
+    },
+    [this](QUuid const&, NodeRecordPtr const& before, NodeRecordPtr const& after) {
+      if (before == after)
+        return;
+
+      NodeChange change{before, after};
+
+      // records are renewed on every recording, compare what they hold
+      if (change.moved() || change.stateChanged())
+        _changedNodes.push_back(std::move(change));
+    });
+
+  // a connection's id is all there is to it
+  from.connections().diff(to.connections(),
+    [this](ConnectionID const& id, NodeDataType const&) {
+      _removedConnections.push_back(id);
+    },
+    [this](ConnectionID const& id, NodeDataType const&) {
+      _addedConnections.push_back(id);
+    },
+    [](ConnectionID const&, NodeDataType const&, NodeDataType const&) {});
+}
+
+
+bool
+SceneDiff::
+isEmpty() const
+{
+  return _addedNodes.empty() && _removedNodes.empty() && _changedNodes.empty() &&
+         _addedConnections.empty() && _removedConnections.empty();
+}
+
+
+void
+SceneDiff::
+apply(DataFlowScene& scene) const
+{
+  auto* model = static_cast<DataFlowModel*>(scene.model());
+
+  for (ConnectionID const& id : _removedConnections)
+  {
+    auto left  = model->nodeIndex(id.lNodeID);
+    auto right = model->nodeIndex(id.rNodeID);
+
+    if (left.isValid() && right.isValid())
+      model->removeConnection(left, id.lPortID, right, id.rPortID);
+  }
+
+  for (auto const& record : _removedNodes)
+  {
+    auto index = model->nodeIndex(record->id);
+
+    if (index.isValid())
+      model->removeNodeWithConnections(index);
+  }
+
+  // nodes of another model are recreated, with all their connections
+  std::unordered_set<QUuid> recreated;
+
+  for (auto const& change : _changedNodes)
+  {
+    auto index = model->nodeIndex(change.after->id);
+
+    if (!index.isValid())
+      continue;
+
+    if (change.before->modelName != change.after->modelName)
+    {
+      model->removeNodeWithConnections(index);
+      scene.restoreNode(change.after->id, change.after->modelName,
+                        change.after->position, change.after->modelState);
+      recreated.insert(change.after->id);
+      continue;
+    }
+
+    if (change.moved())
+      model->moveNode(index, change.after->position);
+
+    if (change.stateChanged())
+    {
+      auto* node = static_cast<Node*>(index.internalPointer());
+
+      node->nodeDataModel()->restore(change.after->modelState);
+      model->commitNodeState(index);
+    }
+  }
+
+  for (auto const& record : _addedNodes)
+  {
+    // applied twice, or the scene got the node some other way
+    if (model->nodeIndex(record->id).isValid())
+      continue;
+
+    scene.restoreNode(record->id, record->modelName, record->position, record->modelState);
+  }
+
+  auto connect = [model](ConnectionID const& id) {
+    auto left  = model->nodeIndex(id.lNodeID);
+    auto right = model->nodeIndex(id.rNodeID);
+
+    if (left.isValid() && right.isValid() && model->_connections.count(id) == 0)
+      model->addConnection(left, id.lPortID, right, id.rPortID);
+  };
+
+  for (ConnectionID const& id : _addedConnections)
+    connect(id);
+
+  if (!recreated.empty())
+  {
+    _to.connections().forEach([&](ConnectionID const& id, NodeDataType const&) {
+      if (recreated.count(id.lNodeID) != 0 || recreated.count(id.rNodeID) != 0)
+        connect(id);
+    });
+  }
+}
+
+//------------------------------------------------------------------------------
+
+SceneMerge::
+SceneMerge(GraphSnapshot const& base,
+           GraphSnapshot const& ours,
+           GraphSnapshot const& theirs)
+{
+  SceneDiff const theirChanges(base, theirs);
+
+  GraphSnapshot::NodeMap       nodes       = ours.nodes();
+  GraphSnapshot::ConnectionMap connections = ours.connections();
+
+  auto conflict = [this](Conflict::Kind kind, QUuid const& node) {
+    _conflicts.push_back(Conflict{kind, node, ConnectionID()});
+  };
+
+  for (auto const& record : theirChanges.addedNodes())
+  {
+    NodeRecordPtr const* ourRecord = nodes.find(record->id);
+
+    if (!ourRecord)
+      nodes = nodes.insert(record->id, record);
+    else if (!sameState(**ourRecord, *record))
+      conflict(Conflict::Kind::State, record->id);
+  }
+
+  // connections by node, only needed to drop those of removed nodes
+  std::unordered_map<QUuid, std::vector<ConnectionID>> ourConnections;
+
+  if (!theirChanges.removedNodes().empty())
+  {
+    ours.connections().forEach([&](ConnectionID const& id, NodeDataType const&) {
+      ourConnections[id.lNodeID].push_back(id);
+      ourConnections[id.rNodeID].push_back(id);
+    });
+  }
+
+  for (auto const& record : theirChanges.removedNodes())
+  {
+    NodeRecordPtr const* ourRecord = nodes.find(record->id);
+
+    // removed on both sides
+    if (!ourRecord)
+      continue;
+
+    if (*ourRecord != record &&
+        ((*ourRecord)->position != record->position || !sameState(**ourRecord, *record)))
+    {
+      conflict(Conflict::Kind::RemovedModified, record->id);
+      continue;
+    }
+
+    nodes = nodes.erase(record->id);
+
+    for (ConnectionID const& id : ourConnections[record->id])
+    {
+      if (!connections.contains(id))
+        continue;
+
+      connections = connections.erase(id);
+
+      if (!base.connections().contains(id))
+        _conflicts.push_back(Conflict{Conflict::Kind::DanglingConnection, record->id, id});
+    }
+  }
+
+  for (auto const& change : theirChanges.changedNodes())
+  {
+    QUuid const& id = change.after->id;
+
+    NodeRecordPtr const* ourRecord = nodes.find(id);
+
+    if (!ourRecord)
+    {
+      conflict(Conflict::Kind::ModifiedRemoved, id);
+      continue;
+    }
+
+    NodeRecord const& original = *change.before;
+    NodeRecord const& mine     = **ourRecord;
+
+    auto merged = std::make_shared<NodeRecord>(mine);
+    bool updated = false;
+
+    if (change.moved())
+    {
+      if (mine.position == original.position)
+      {
+        merged->position = change.after->position;
+        updated = true;
+      }
+      else if (mine.position != change.after->position)
+      {
+        conflict(Conflict::Kind::Position, id);
+      }
+    }
+
+    if (change.stateChanged())
+    {
+      if (sameState(mine, original))
+      {
+        merged->modelName  = change.after->modelName;
+        merged->modelState = change.after->modelState;
+        updated = true;
+      }
+      else if (!sameState(mine, *change.after))
+      {
+        conflict(Conflict::Kind::State, id);
+      }
+    }
+
+    if (updated)
+      nodes = nodes.insert(id, std::move(merged));
+  }
+
+  for (ConnectionID const& id : theirChanges.removedConnections())
+    connections = connections.erase(id);
+
+  for (ConnectionID const& id : theirChanges.addedConnections())
+  {
+    if (nodes.contains(id.lNodeID) && nodes.contains(id.rNodeID))
+    {
+      NodeDataType const* type = theirs.connections().find(id);
+      connections = connections.insert(id, type ? *type : NodeDataType());
+    }
+    else
+    {
+      QUuid const& missing = nodes.contains(id.lNodeID) ? id.rNodeID : id.lNodeID;
+      _conflicts.push_back(Conflict{Conflict::Kind::DanglingConnection, missing, id});
+    }
+  }
+
+  _result = GraphSnapshot(std::move(nodes), std::move(connections),
+                          std::max(ours.version(), theirs.version()) + 1);
+}
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QUuid>
+
+#include "Export.hpp"
+#include "ConnectionID.hpp"
+#include "GraphSnapshot.hpp"
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+
+/// Structural difference between two versions of a graph, keyed by node id.
+///
+/// Snapshots taken from the same DataFlowModel share every unchanged part,
+/// and the comparison skips what they share (see `PersistentMap::diff`), so
+/// it costs in proportion to the changes. Unrelated snapshots, such as two
+/// files read with `GraphSnapshot::fromJson`, are compared in one linear
+/// pass without lookups.
+class NODE_EDITOR_PUBLIC SceneDiff
+{
+public:
+
+  struct NodeChange
+  {
+    GraphSnapshot::NodeRecordPtr before;
+    GraphSnapshot::NodeRecordPtr after;
+
+    bool
+    moved() const { return before->position != after->position; }
+
+    /// Model name or state differ
+    bool
+    stateChanged() const
+    {
+      return before->modelName != after->modelName ||
+             before->modelState != after->modelState;
+    }
+  };
+
+public:
+
+  SceneDiff() = default;
+
+  SceneDiff(GraphSnapshot const& from, GraphSnapshot const& to);
+
+  std::vector<GraphSnapshot::NodeRecordPtr> const&
+  addedNodes() const { return _addedNodes; }
+
+  std::vector<GraphSnapshot::NodeRecordPtr> const&
+  removedNodes() const { return _removedNodes; }
+
+  /// Nodes in both versions that moved or changed state
+  std::vector<NodeChange> const&
+  changedNodes() const { return _changedNodes; }
+
+  std::vector<ConnectionID> const&
+  addedConnections() const { return _addedConnections; }
+
+  std::vector<ConnectionID> const&
+  removedConnections() const { return _removedConnections; }
+
+  bool
+  isEmpty() const;
+
+  /// Turns a scene showing the `from` version into the `to` version.
+  /// Nodes whose model changed are recreated. Wrap large diffs in a bulk
+  /// load of the scene's DataFlowModel.
+  void
+  apply(DataFlowScene& scene) const;
+
+private:
+
+  GraphSnapshot _to;
+
+  std::vector<GraphSnapshot::NodeRecordPtr> _addedNodes;
+  std::vector<GraphSnapshot::NodeRecordPtr> _removedNodes;
+  std::vector<NodeChange>                   _changedNodes;
+
+  std::vector<ConnectionID> _addedConnections;
+  std::vector<ConnectionID> _removedConnections;
+};
+
+
+/// Three-way merge of two versions of a graph derived from a common base.
+///
+/// Their changes relative to the base are applied to ours; position and
+/// state of a node merge independently. Where both sides changed the same
+/// thing differently, or one removed what the other changed, ours is kept
+/// and a conflict is reported.
+class NODE_EDITOR_PUBLIC SceneMerge
+{
+public:
+
+  struct Conflict
+  {
+    enum class Kind
+    {
+      Position,        ///< both moved the node to different places
+      State,           ///< both changed the node's state differently
+      RemovedModified, ///< they removed a node we changed, it is kept
+      ModifiedRemoved, ///< they changed a node we removed, it stays removed
+      DanglingConnection ///< a connection added to a node the other removed
+    };
+
+    Kind         kind;
+    QUuid        node;
+    ConnectionID connection; ///< for DanglingConnection
+  };
+
+public:
+
+  SceneMerge(GraphSnapshot const& base,
+             GraphSnapshot const& ours,
+             GraphSnapshot const& theirs);
+
+  GraphSnapshot const&
+  result() const { return _result; }
+
+  std::vector<Conflict> const&
+  conflicts() const { return _conflicts; }
+
+  bool
+  hasConflicts() const { return !_conflicts.empty(); }
+
+private:
+
+  GraphSnapshot         _result;
+  std::vector<Conflict> _conflicts;
+};
+}
@@ -0,0 +1,588 @@
+#include "SceneJournal.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QSaveFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QDebug>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "BinaryScene.hpp"
+
+namespace QtNodes {
+
+namespace
+{
+
+constexpr char    JournalMagic[4] = {'Q', 'N', 'S', 'J'};
+constexpr quint16 JournalVersion  = 1;
+
+// key of the snapshot's extra section holding the generation
+QString const GenerationKey = QStringLiteral("journalGeneration");
+
+enum class RecordType : quint8
+{
+  NodeAdded = 1,
+  NodeRemoved,
+  NodeMoved,
+  NodeState,
+  ConnectionAdded,
+  ConnectionRemoved
+};
+
+// Records are framed as u32 payload length, payload, u16 checksum of the
+// payload; the payload starts with its RecordType
+class RecordWriter
+{
+public:
+
+  explicit
+  RecordWriter(QFile& file)
+    : _file(file)
+    , _stream(&_payload, QIODevice::WriteOnly)
+  {
+    _stream.setByteOrder(QDataStream::LittleEndian);
+  }
+
+  QDataStream&
+  begin(RecordType type)
+  {
+    _payload.clear();
+    _stream.device()->seek(0);
+    _stream << quint8(type);
+    return _stream;
+  }
+
+  void
+  end()
+  {
+    QByteArray frame;
+    QDataStream stream(&frame, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream << quint32(_payload.size());
+    stream.writeRawData(_payload.constData(), _payload.size());
+    stream << quint16(qChecksum(_payload.constData(), uint(_payload.size())));
+
+    _file.write(frame);
+  }
+
+private:
+
+  QFile&      _file;
+  QByteArray  _payload;
+  QDataStream _stream;
+};
+
+
+QByteArray
+encodeState(QJsonObject const& state)
+{
+  return QJsonDocument(state).toJson(QJsonDocument::Compact);
+}
+
+
+QJsonObject
+decodeState(QByteArray const& bytes)
+{
+  return QJsonDocument::fromJson(bytes).object();
+}
+
+
+QByteArray
+snapshotData(GraphSnapshot const& snapshot, quint64 generation)
+{
+  BinarySceneWriter writer(snapshot.nodes().size(), snapshot.connections().size());
+
+  // the recorded states, no model is asked to save again
+  snapshot.nodes().forEach([&](QUuid const& id, GraphSnapshot::NodeRecordPtr const& record)
+  {
+    writer.addNode(id, record->position, record->modelState);
+  });
+
+  snapshot.connections().forEach([&](ConnectionID const& id, NodeDataType const&)
+  {
+    writer.addConnection(id.lNodeID, id.lPortID, id.rNodeID, id.rPortID);
+  });
+
+  QJsonObject extra;
+  extra[GenerationKey] = double(generation);
+  writer.setExtra(extra);
+
+  return writer.finish();
+}
+
+
+ConnectionID
+connectionId(NodeIndex const& leftNode, PortIndex leftPort,
+             NodeIndex const& rightNode, PortIndex rightPort)
+{
+  ConnectionID id;
+  id.lNodeID = leftNode.id();
+  id.rNodeID = rightNode.id();
+  id.lPortID = leftPort;
+  id.rPortID = rightPort;
+  return id;
+}
+
+
+/// Applies one record to the model, false if the payload is malformed
+bool
+replay(DataFlowScene& scene, DataFlowModel& model, QByteArray const& payload)
+{
+  QDataStream stream(payload);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  quint8 type;
+  QUuid  id;
+  stream >> type >> id;
+
+  switch (RecordType(type))
+  {
+    case RecordType::NodeAdded:
+    {
+      QString    modelName;
+      QPointF    position;
+      QByteArray state;
+      stream >> modelName >> position >> state;
+
+      if (stream.status() != QDataStream::Ok)
+        return false;
+
+      if (model.nodeIndex(id).isValid())
+        model.removeNodeWithConnections(model.nodeIndex(id));
+
+      try
+      {
+        scene.restoreNode(id, modelName, position, decodeState(state));
+      }
+      catch (std::logic_error const& error)
+      {
+        qWarning() << "Couldn't replay node" << id << ":" << error.what();
+      }
+      return true;
+    }
+
+    case RecordType::NodeRemoved:
+    {
+      if (model.nodeIndex(id).isValid())
+        model.removeNodeWithConnections(model.nodeIndex(id));
+      return stream.status() == QDataStream::Ok;
+    }
+
+    case RecordType::NodeMoved:
+    {
+      QPointF position;
+      stream >> position;
+
+      if (stream.status() != QDataStream::Ok)
+        return false;
+
+      auto index = model.nodeIndex(id);
+      if (index.isValid())
+        model.moveNode(index, position);
+      return true;
+    }
+
+    case RecordType::NodeState:
+    {
+      QByteArray state;
+      stream >> state;
+
+      if (stream.status() != QDataStream::Ok)
+        return false;
+
+      auto index = model.nodeIndex(id);
+      if (index.isValid())
+      {
+        model._nodes[id]->nodeDataModel()->restore(decodeState(state));
+        model.commitNodeState(index);
+      }
+      return true;
+    }
+
+    case RecordType::ConnectionAdded:
+    case RecordType::ConnectionRemoved:
+    {
+      qint32 outPort;
+      QUuid  inNode;
+      qint32 inPort;
+      stream >> outPort >> inNode >> inPort;
+
+      if (stream.status() != QDataStream::Ok)
+        return false;
+
+      auto outIndex = model.nodeIndex(id);
+      auto inIndex  = model.nodeIndex(inNode);
+
+      if (!outIndex.isValid() || !inIndex.isValid())
+        return true;
+
+      ConnectionID const connection = connectionId(outIndex, outPort, inIndex, inPort);
+      bool const exists = model._connections.count(connection) != 0;
+
+      if (RecordType(type) == RecordType::ConnectionAdded && !exists)
+        model.addConnection(outIndex, outPort, inIndex, inPort);
+      else if (RecordType(type) == RecordType::ConnectionRemoved && exists)
+        model.removeConnection(outIndex, outPort, inIndex, inPort);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}
+
+SceneJournal::
+SceneJournal(DataFlowScene& scene,
+             QString const& fileName,
+             QObject* parent)
+  : QObject(parent)
+  , _scene(scene)
+  , _model(*static_cast<DataFlowModel*>(scene.model()))
+  , _fileName(fileName)
+{
+  _timer.setSingleShot(true);
+  _timer.setInterval(1000);
+  connect(&_timer, &QTimer::timeout, this, &SceneJournal::flush);
+}
+
+
+SceneJournal::
+~SceneJournal()
+{
+  stop();
+}
+
+
+bool
+SceneJournal::
+start()
+{
+  if (isRecording())
+    return true;
+
+  if (!compact())
+    return false;
+
+  auto model = &_model;
+
+  // node states are journaled as they change, not at the next snapshot
+  _model.watchNodeStates();
+
+  _modelConnections = {
+    connect(model, &FlowSceneModel::nodeAdded, this, &SceneJournal::nodeChanged),
+    connect(model, &FlowSceneModel::nodeRemoved, this, &SceneJournal::nodeChanged),
+    connect(model, &DataFlowModel::nodeStateCommitted, this, &SceneJournal::nodeChanged),
+    connect(model, &FlowSceneModel::nodeMoved, this, [this](NodeIndex const& index) {
+      nodeChanged(index.id());
+    }),
+    connect(model, &FlowSceneModel::connectionAdded, this,
+            [this](NodeIndex const& leftNode, PortIndex leftPort, NodeIndex const& rightNode, PortIndex rightPort) {
+      connectionChanged(connectionId(leftNode, leftPort, rightNode, rightPort));
+    }),
+    connect(model, &FlowSceneModel::connectionRemoved, this,
+            [this](NodeIndex const& leftNode, PortIndex leftPort, NodeIndex const& rightNode, PortIndex rightPort) {
+      connectionChanged(connectionId(leftNode, leftPort, rightNode, rightPort));
+    }),
+    connect(model, &FlowSceneModel::modelReset, this, [this] {
+      _resetPending = true;
+      if (!_timer.isActive())
+        _timer.start();
+    })
+  };
+
+  return true;
+}
+
+
+void
+SceneJournal::
+stop()
+{
+  if (!isRecording())
+    return;
+
+  flush();
+
+  // compact() alone opens the journal without watching
+  if (!_modelConnections.empty())
+    _model.unwatchNodeStates();
+
+  for (auto const& connection : _modelConnections)
+    disconnect(connection);
+  _modelConnections.clear();
+
+  _timer.stop();
+  _journal.close();
+}
+
+
+void
+SceneJournal::
+flush()
+{
+  _timer.stop();
+
+  if (!_journal.isOpen())
+    return;
+
+  if (_resetPending)
+  {
+    compact();
+    return;
+  }
+
+  if (_dirtyNodes.empty() && _dirtyConnections.empty())
+    return;
+
+  writeChanges(_model.snapshot());
+
+  _journal.flush();
+
+  if (_journal.size() > std::max(_compactionThreshold, _snapshotSize))
+    compact();
+}
+
+
+bool
+SceneJournal::
+compact()
+{
+  GraphSnapshot const current = _model.snapshot();
+
+  quint64 const generation = _generation + 1;
+
+  QByteArray const data = snapshotData(current, generation);
+
+  // the old snapshot stays intact until the new one is complete; a journal
+  // left behind by a crash in between has an older generation and is
+  // ignored by recover()
+  QSaveFile snapshot(_fileName);
+
+  if (!snapshot.open(QIODevice::WriteOnly) ||
+      snapshot.write(data) != data.size() ||
+      !snapshot.commit())
+  {
+    _errorString = snapshot.errorString();
+    return false;
+  }
+
+  _generation   = generation;
+  _snapshotSize = data.size();
+  _written      = current;
+
+  _dirtyNodes.clear();
+  _dirtyConnections.clear();
+  _resetPending = false;
+
+  return openJournal();
+}
+
+
+bool
+SceneJournal::
+recover(DataFlowScene& scene, QString const& fileName)
+{
+  QFile snapshotFile(fileName);
+
+  if (!snapshotFile.open(QIODevice::ReadOnly))
+    return false;
+
+  QByteArray const snapshot = snapshotFile.readAll();
+
+  BinarySceneReader const reader(snapshot);
+
+  if (!reader.isValid())
+    return false;
+
+  quint64 const generation = quint64(reader.extra()[GenerationKey].toDouble());
+
+  auto& model = *static_cast<DataFlowModel*>(scene.model());
+
+  // the records refer to the saved ids, nodes already in the scene would
+  // get the snapshot's ones remapped away from them
+  scene.clearScene();
+
+  // one graphics rebuild and evaluation for the snapshot and the journal
+  model.beginBulkLoad();
+
+  scene.loadFromMemory(snapshot);
+
+  QFile journal(fileName + ".journal");
+
+  if (journal.open(QIODevice::ReadOnly))
+  {
+    QDataStream stream(&journal);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    char    magic[sizeof(JournalMagic)] = {};
+    quint16 version           = 0;
+    quint64 journalGeneration = 0;
+
+    stream.readRawData(magic, sizeof(magic));
+    stream >> version >> journalGeneration;
+
+    // an older journal is already part of the snapshot
+    bool const current = stream.status() == QDataStream::Ok &&
+                         std::equal(magic, magic + sizeof(magic), JournalMagic) &&
+                         version == JournalVersion &&
+                         journalGeneration == generation;
+
+    while (current && !stream.atEnd())
+    {
+      quint32 length;
+      stream >> length;
+
+      if (stream.status() != QDataStream::Ok ||
+          qint64(length) + 2 > journal.bytesAvailable())
+        break; // torn by a crash
+
+      QByteArray payload(int(length), Qt::Uninitialized);
+      stream.readRawData(payload.data(), int(length));
+
+      quint16 checksum;
+      stream >> checksum;
+
+      if (checksum != qChecksum(payload.constData(), length) ||
+          !replay(scene, model, payload))
+        break;
+    }
+  }
+
+  model.endBulkLoad();
+
+  return true;
+}
+
+
+void
+SceneJournal::
+nodeChanged(QUuid const& id)
+{
+  _dirtyNodes.insert(id);
+
+  if (!_timer.isActive())
+    _timer.start();
+}
+
+
+void
+SceneJournal::
+connectionChanged(ConnectionID const& id)
+{
+  _dirtyConnections.insert(id);
+
+  if (!_timer.isActive())
+    _timer.start();
+}
+
+
+void
+SceneJournal::
+writeChanges(GraphSnapshot const& current)
+{
+  RecordWriter writer(_journal);
+
+  auto writeConnection = [&](RecordType type, ConnectionID const& id) {
+    writer.begin(type) << id.lNodeID << qint32(id.lPortID) << id.rNodeID << qint32(id.rPortID);
+    writer.end();
+  };
+
+  // removals first, then additions, then changes, so that every record
+  // refers to nodes that exist when it is replayed
+
+  for (ConnectionID const& id : _dirtyConnections)
+  {
+    if (_written.connections().contains(id) && !current.connections().contains(id))
+      writeConnection(RecordType::ConnectionRemoved, id);
+  }
+
+  std::vector<NodeRecord const*> added;
+
+  for (QUuid const& id : _dirtyNodes)
+  {
+    NodeRecord const* before = _written.node(id);
+    NodeRecord const* after  = current.node(id);
+
+    if (before == after)
+      continue;
+
+    // a node replaced under the same id counts as removed and added
+    if (before && (!after || before->modelName != after->modelName))
+    {
+      writer.begin(RecordType::NodeRemoved) << id;
+      writer.end();
+      before = nullptr;
+    }
+
+    if (!after)
+      continue;
+
+    if (!before)
+    {
+      added.push_back(after);
+      continue;
+    }
+
+    if (before->position != after->position)
+    {
+      writer.begin(RecordType::NodeMoved) << id << after->position;
+      writer.end();
+    }
+
+    if (before->modelState != after->modelState)
+    {
+      writer.begin(RecordType::NodeState) << id << encodeState(after->modelState);
+      writer.end();
+    }
+  }
+
+  for (NodeRecord const* record : added)
+  {
+    writer.begin(RecordType::NodeAdded) << record->id << record->modelName
+                                        << record->position << encodeState(record->modelState);
+    writer.end();
+  }
+
+  for (ConnectionID const& id : _dirtyConnections)
+  {
+    if (!_written.connections().contains(id) && current.connections().contains(id))
+      writeConnection(RecordType::ConnectionAdded, id);
+  }
+
+  _written = current;
+
+  _dirtyNodes.clear();
+  _dirtyConnections.clear();
+}
+
+
+bool
+SceneJournal::
+openJournal()
+{
+  _journal.close();
+  _journal.setFileName(journalFileName());
+
+  if (!_journal.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    _errorString = _journal.errorString();
+    return false;
+  }
+
+  QDataStream stream(&_journal);
+  stream.setByteOrder(QDataStream::LittleEndian);
+
+  stream.writeRawData(JournalMagic, sizeof(JournalMagic));
+  stream << JournalVersion << _generation;
+
+  _journal.flush();
+
+  return true;
+}
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+#include <QtCore/QString>
+
+#include "Export.hpp"
+#include "ConnectionID.hpp"
+#include "GraphSnapshot.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+class DataFlowModel;
+
+/// Autosave of a DataFlowScene as a snapshot plus an append-only journal.
+///
+/// `fileName` receives a full binary snapshot (see BinaryScene) and
+/// `fileName + ".journal"` the changes made since, as delta records: node
+/// added, removed, moved or with a new model state, connection added or
+/// removed. Changes are collected as they happen and written on a timer;
+/// repeated moves or edits of a node in between become a single record, and
+/// the states written are those DataFlowModel already recorded for its
+/// snapshots, so writing costs in proportion to what was edited. Loads,
+/// pastes and imports into the scene are bulk loads, whose nodes and
+/// connections the model announces one by one at their end; they are
+/// journaled as individual records like any other addition.
+///
+/// Once the journal outgrows both `compactionThreshold()` and the last
+/// snapshot, a new snapshot is written atomically and the journal starts
+/// over. `recover()` rebuilds the scene from the snapshot and the journal,
+/// ignoring a record torn by a crash.
+class NODE_EDITOR_PUBLIC SceneJournal
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  SceneJournal(DataFlowScene& scene,
+               QString const& fileName,
+               QObject* parent = nullptr);
+
+  ~SceneJournal();
+
+  /// Writes a snapshot of the scene and starts recording changes
+  bool
+  start();
+
+  /// Flushes and stops recording
+  void
+  stop();
+
+  bool
+  isRecording() const { return _journal.isOpen(); }
+
+  QString
+  errorString() const { return _errorString; }
+
+  QString
+  journalFileName() const { return _fileName + ".journal"; }
+
+  int
+  flushInterval() const { return _timer.interval(); }
+
+  /// Milliseconds between a change and its journal record, 1000 by default
+  void
+  setFlushInterval(int milliseconds) { _timer.setInterval(milliseconds); }
+
+  qint64
+  compactionThreshold() const { return _compactionThreshold; }
+
+  void
+  setCompactionThreshold(qint64 bytes) { _compactionThreshold = bytes; }
+
+  /// Writes the pending changes now
+  void
+  flush();
+
+  /// Writes a new snapshot and empties the journal
+  bool
+  compact();
+
+  /// Empties `scene`, loads the snapshot at `fileName` into it and replays
+  /// its journal. The scene is left untouched if the snapshot is unreadable.
+  static bool
+  recover(DataFlowScene& scene, QString const& fileName);
+
+private:
+
+  void
+  nodeChanged(QUuid const& id);
+
+  void
+  connectionChanged(ConnectionID const& id);
+
+  /// Appends the records turning `_written` into `current`
+  void
+  writeChanges(GraphSnapshot const& current);
+
+  bool
+  openJournal();
+
+private:
+
+  DataFlowScene& _scene;
+  DataFlowModel& _model;
+
+  QString _fileName;
+  QString _errorString;
+
+  QFile  _journal;
+  QTimer _timer;
+
+  qint64 _compactionThreshold = 1 << 20;
+  qint64 _snapshotSize        = 0;
+
+  // matches the snapshot with the journal that continues it
+  quint64 _generation = 0;
+
+  // the graph as of the last snapshot or record
+  GraphSnapshot _written;
+
+  std::unordered_set<QUuid>        _dirtyNodes;
+  std::unordered_set<ConnectionID> _dirtyConnections;
+
+  // a model reset, changed without per-item signals: only a snapshot will
+  // do. DataFlowModel's bulk loads don't reset.
+  bool _resetPending = false;
+
+  std::vector<QMetaObject::Connection> _modelConnections;
+};
+}
@@ -0,0 +1,454 @@
+#include "SceneLoader.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "DataFlowScene.hpp"
+#include "DataFlowModel.hpp"
+#include "BinaryScene.hpp"
+
+namespace QtNodes {
+
+SceneLoader::
+SceneLoader(DataFlowScene& scene, QObject* parent)
+  : QObject(parent)
+  , _scene(scene)
+{
+  // run a batch whenever the event loop is idle
+  _timer.setInterval(0);
+  connect(&_timer, &QTimer::timeout, this, &SceneLoader::processBatch);
+}
+
+
+SceneLoader::
+~SceneLoader()
+{
+  _timer.stop();
+  release();
+}
+
+
+bool
+SceneLoader::
+start(QString const& fileName)
+{
+  if (isRunning())
+    return false;
+
+  _file.setFileName(fileName);
+
+  if (!_file.open(QIODevice::ReadOnly))
+  {
+    _errorString = _file.errorString();
+    return false;
+  }
+
+  _errorString.clear();
+
+  _buffer.clear();
+  _scanPosition = 0;
+  _depth        = 0;
+  _inString     = false;
+  _escape       = false;
+  _keyStart     = -1;
+  _section      = Section::None;
+  _elementStart = -1;
+  _elements.clear();
+  _waiting.clear();
+  _loadedIds.clear();
+
+  QByteArray const head = _file.peek(BinaryScene::HeaderSize);
+
+  if (BinaryScene::isBinary(head))
+  {
+    _mapped = _file.map(0, _file.size());
+
+    if (_mapped)
+    {
+      _binary = std::make_unique<BinarySceneReader>(reinterpret_cast<char const*>(_mapped),
+                                                    std::size_t(_file.size()));
+    }
+
+    std::vector<BinarySceneReader::ConnectionEntry> connections;
+
+    if (!_binary || !_binary->isValid() || !_binary->connections(connections))
+    {
+      _errorString = tr("Invalid binary scene");
+      release();
+      return false;
+    }
+
+    _nextBinaryNode = 0;
+
+    for (auto const& connection : connections)
+    {
+      connectWhenReady(PendingConnection{connection.outNode, connection.outPort,
+                                         connection.inNode, connection.inPort});
+    }
+  }
+
+  _timer.start();
+
+  return true;
+}
+
+
+void
+SceneLoader::
+cancel()
+{
+  if (isRunning())
+  {
+    finish(false);
+  }
+}
+
+
+void
+SceneLoader::
+processBatch()
+{
+  auto& model = *static_cast<DataFlowModel*>(_scene.model());
+
+  model.beginBulkLoad();
+
+  BatchResult const result = restoreBatch();
+
+  model.endBulkLoad();
+
+  // cancelled from a slot, finished was emitted then
+  if (!isRunning())
+    return;
+
+  if (result != BatchResult::Running)
+    finish(result == BatchResult::Completed);
+}
+
+
+SceneLoader::BatchResult
+SceneLoader::
+restoreBatch()
+{
+  QElapsedTimer clock;
+  clock.start();
+
+  int created = 0;
+
+  try
+  {
+    if (_binary)
+    {
+      while (_nextBinaryNode < _binary->nodeCount() &&
+             created < _batchSize && clock.elapsed() < _timeBudget)
+      {
+        auto const entry = _binary->node(_nextBinaryNode++);
+
+        restoreNode(entry.id, entry.modelName, entry.position, _binary->modelState(entry));
+
+        ++created;
+      }
+
+      bool const done = _nextBinaryNode == _binary->nodeCount();
+
+      // a slot may cancel, which releases the reader
+      emit progress(qint64(_nextBinaryNode), qint64(_binary->nodeCount()));
+
+      return done ? BatchResult::Completed : BatchResult::Running;
+    }
+
+    while (created < _batchSize && clock.elapsed() < _timeBudget)
+    {
+      if (_elements.empty())
+      {
+        if (readChunk())
+          continue;
+
+        if (!_errorString.isEmpty())
+          return BatchResult::Failed;
+
+        emit progress(_file.size(), _file.size());
+        return BatchResult::Completed;
+      }
+
+      Element const element = std::move(_elements.front());
+      _elements.pop_front();
+
+      apply(element);
+
+      if (element.section == Section::Nodes)
+        ++created;
+    }
+  }
+  catch (std::logic_error const& error)
+  {
+    _errorString = QString::fromLocal8Bit(error.what());
+    return BatchResult::Failed;
+  }
+
+  emit progress(_file.pos(), _file.size());
+
+  return BatchResult::Running;
+}
+
+
+bool
+SceneLoader::
+readChunk()
+{
+  if (_file.atEnd())
+  {
+    if (_depth != 0 || _inString)
+      _errorString = tr("Unexpected end of file");
+
+    return false;
+  }
+
+  _buffer.append(_file.read(_chunkSize));
+
+  if (!scan())
+  {
+    _errorString = tr("Malformed scene file");
+    return false;
+  }
+
+  // drop what has been scanned, keeping an unfinished element or key
+  int keep = _scanPosition;
+  if (_elementStart >= 0)
+    keep = std::min(keep, _elementStart);
+  if (_keyStart >= 0)
+    keep = std::min(keep, _keyStart);
+
+  _buffer.remove(0, keep);
+  _scanPosition -= keep;
+  if (_elementStart >= 0)
+    _elementStart -= keep;
+  if (_keyStart >= 0)
+    _keyStart -= keep;
+
+  return true;
+}
+
+
+bool
+SceneLoader::
+scan()
+{
+  char const* data = _buffer.constData();
+  int const   size = _buffer.size();
+
+  for (; _scanPosition < size; ++_scanPosition)
+  {
+    char const c = data[_scanPosition];
+
+    if (_inString)
+    {
+      if (_escape)
+      {
+        _escape = false;
+      }
+      else if (c == '\\')
+      {
+        _escape = true;
+      }
+      else if (c == '"')
+      {
+        _inString = false;
+
+        // strings directly in the scene object; the last one before an
+        // array is its key
+        if (_keyStart >= 0)
+        {
+          _lastKey  = QByteArray(data + _keyStart, _scanPosition - _keyStart);
+          _keyStart = -1;
+        }
+      }
+      continue;
+    }
+
+    switch (c)
+    {
+      case '"':
+        _inString = true;
+        if (_depth == 1)
+          _keyStart = _scanPosition + 1;
+        break;
+
+      case '{':
+      case '[':
+        ++_depth;
+
+        if (_depth == 2 && c == '[')
+        {
+          if (_lastKey == "nodes")
+            _section = Section::Nodes;
+          else if (_lastKey == "connections")
+            _section = Section::Connections;
+        }
+        else if (_depth == 3 && c == '{' && _section != Section::None)
+        {
+          _elementStart = _scanPosition;
+        }
+        break;
+
+      case '}':
+      case ']':
+        if (_depth == 3 && _elementStart >= 0)
+        {
+          _elements.push_back(Element{_section,
+                                      _buffer.mid(_elementStart, _scanPosition + 1 - _elementStart)});
+          _elementStart = -1;
+        }
+        else if (_depth == 2)
+        {
+          _section = Section::None;
+        }
+
+        if (--_depth < 0)
+          return false;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+
+void
+SceneLoader::
+apply(Element const& element)
+{
+  QJsonObject const json = QJsonDocument::fromJson(element.json).object();
+
+  if (element.section == Section::Nodes)
+  {
+    QJsonObject const modelJson    = json["model"].toObject();
+    QJsonObject const positionJson = json["position"].toObject();
+
+    restoreNode(QUuid(json["id"].toString()),
+                modelJson["name"].toString(),
+                QPointF(positionJson["x"].toDouble(), positionJson["y"].toDouble()),
+                modelJson);
+    return;
+  }
+
+  connectWhenReady(PendingConnection{QUuid(json["out_id"].toString()),
+                                     json["out_index"].toInt(),
+                                     QUuid(json["in_id"].toString()),
+                                     json["in_index"].toInt()});
+}
+
+
+void
+SceneLoader::
+restoreNode(QUuid const& id,
+            QString const& modelName,
+            QPointF const& position,
+            QJsonObject const& modelState)
+{
+  bool const repeated = id.isNull() || _loadedIds.count(id) != 0;
+
+  // ids the scene already uses get fresh ones, the connections follow
+  QUuid const sceneId = repeated || _scene.model()->nodeIndex(id).isValid()
+                        ? QUuid::createUuid()
+                        : id;
+
+  _scene.restoreNode(sceneId, modelName, position, modelState);
+
+  // connections go to the first node of a repeated id
+  if (!repeated)
+  {
+    _loadedIds[id] = sceneId;
+    nodeRestored(id);
+  }
+}
+
+
+void
+SceneLoader::
+connectWhenReady(PendingConnection const& connection)
+{
+  auto outIter = _loadedIds.find(connection.outNode);
+  if (outIter == _loadedIds.end())
+  {
+    _waiting[connection.outNode].push_back(connection);
+    return;
+  }
+
+  auto inIter = _loadedIds.find(connection.inNode);
+  if (inIter == _loadedIds.end())
+  {
+    _waiting[connection.inNode].push_back(connection);
+    return;
+  }
+
+  auto model = _scene.model();
+
+  // the nodes may have been removed since
+  NodeIndex const outNode = model->nodeIndex(outIter->second);
+  NodeIndex const inNode  = model->nodeIndex(inIter->second);
+
+  if (outNode.isValid() && inNode.isValid())
+    model->addConnection(outNode, connection.outPort, inNode, connection.inPort);
+}
+
+
+void
+SceneLoader::
+nodeRestored(QUuid const& id)
+{
+  auto iter = _waiting.find(id);
+
+  if (iter == _waiting.end())
+    return;
+
+  std::vector<PendingConnection> const waiting = std::move(iter->second);
+  _waiting.erase(iter);
+
+  for (auto const& connection : waiting)
+  {
+    connectWhenReady(connection);
+  }
+}
+
+
+void
+SceneLoader::
+finish(bool completed)
+{
+  _timer.stop();
+
+  release();
+
+  emit finished(completed);
+}
+
+
+void
+SceneLoader::
+release()
+{
+  _binary.reset();
+
+  if (_mapped)
+  {
+    _file.unmap(_mapped);
+    _mapped = nullptr;
+  }
+
+  _file.close();
+
+  _buffer.clear();
+  _elements.clear();
+
+  // connections to nodes that never showed up
+  _waiting.clear();
+  _loadedIds.clear();
+}
+}
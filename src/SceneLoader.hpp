@@ -0,0 +1,185 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QPointF>
+#include <QtCore/QJsonObject>
+
+#include "Export.hpp"
+#include "PortType.hpp"
+#include "QUuidStdHash.hpp"
+
+namespace QtNodes
+{
+
+class DataFlowScene;
+class BinarySceneReader;
+
+/// Loads a scene file into a DataFlowScene a little at a time from the
+/// event loop, so that the scene fills in progressively and the UI stays
+/// responsive.
+///
+/// JSON files are read in chunks and scanned for the elements of the
+/// "nodes" and "connections" arrays, each element being parsed on its own;
+/// the whole document is never held in memory. Binary files
+/// (see BinaryScene) are memory mapped. Every tick creates at most
+/// `batchSize()` nodes and spends at most `timeBudget()` milliseconds, as
+/// one bulk load of the model: the views get a batch's nodes at once,
+/// evaluated. Connections are made as soon as both of their nodes exist.
+class NODE_EDITOR_PUBLIC SceneLoader
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  SceneLoader(DataFlowScene& scene, QObject* parent = nullptr);
+
+  ~SceneLoader();
+
+  /// Starts loading `fileName` into the scene, adding to what it contains;
+  /// nodes whose id is already in use are loaded under a fresh one.
+  /// Returns false if the file cannot be opened or a load is running.
+  bool
+  start(QString const& fileName);
+
+  /// Stops loading; what was created so far stays in the scene. May be
+  /// called from the slots of `progress` and of the scene's signals.
+  void
+  cancel();
+
+  bool
+  isRunning() const { return _timer.isActive(); }
+
+  QString
+  errorString() const { return _errorString; }
+
+  int
+  batchSize() const { return _batchSize; }
+
+  void
+  setBatchSize(int nodes) { _batchSize = nodes; }
+
+  int
+  timeBudget() const { return _timeBudget; }
+
+  void
+  setTimeBudget(int milliseconds) { _timeBudget = milliseconds; }
+
+signals:
+
+  void
+  progress(qint64 done, qint64 total);
+
+  /// `completed` is false if the load was cancelled or failed
+  void
+  finished(bool completed);
+
+private slots:
+
+  void
+  processBatch();
+
+private:
+
+  enum class Section { None, Nodes, Connections };
+
+  enum class BatchResult { Running, Completed, Failed };
+
+  struct Element
+  {
+    Section    section;
+    QByteArray json;
+  };
+
+  struct PendingConnection
+  {
+    QUuid     outNode;
+    PortIndex outPort;
+    QUuid     inNode;
+    PortIndex inPort;
+  };
+
+  /// Creates the nodes of one tick, the caller finishes the load as told
+  BatchResult
+  restoreBatch();
+
+  /// Reads and scans the next chunk of a JSON file, false at the end
+  bool
+  readChunk();
+
+  /// Moves complete array elements from the buffer to `_elements`
+  bool
+  scan();
+
+  void
+  apply(Element const& element);
+
+  /// Restores a node of the file, under a fresh id if the scene uses `id`
+  void
+  restoreNode(QUuid const& id,
+              QString const& modelName,
+              QPointF const& position,
+              QJsonObject const& modelState);
+
+  void
+  connectWhenReady(PendingConnection const& connection);
+
+  void
+  nodeRestored(QUuid const& id);
+
+  void
+  finish(bool completed);
+
+  /// Closes the file and drops all loading state
+  void
+  release();
+
+private:
+
+  DataFlowScene& _scene;
+
+  QTimer _timer;
+  QFile  _file;
+
+  int _batchSize  = 200;
+  int _timeBudget = 15;
+
+  qint64 _chunkSize = 1 << 16;
+
+  QString _errorString;
+
+  // JSON scanning state
+  QByteArray _buffer;
+  int        _scanPosition = 0;
+  int        _depth        = 0;
+  bool       _inString     = false;
+  bool       _escape       = false;
+  int        _keyStart     = -1;
+  QByteArray _lastKey;
+  Section    _section      = Section::None;
+  int        _elementStart = -1;
+
+  std::deque<Element> _elements;
+
+  // binary files
+  uchar*                             _mapped = nullptr;
+  std::unique_ptr<BinarySceneReader> _binary;
+  std::size_t                        _nextBinaryNode = 0;
+
+  // connections waiting for the node with the given id
+  std::unordered_map<QUuid, std::vector<PendingConnection>> _waiting;
+
+  // ids in the file of the nodes restored so far, to their ids in the scene
+  std::unordered_map<QUuid, QUuid> _loadedIds;
+};
+}